@@ -0,0 +1,96 @@
+#include <atomic>
+#include <mutex>
+#include <cstdlib>
+#include <new>
+
+#include "Profiler.h"
+
+// replaces the global operator new and delete so heap allocations can be counted, and hands
+// the profiler the counts. only the programs that report allocations (RobotWarz and ArenaBench)
+// link this in; everything else keeps the library's own operator new and reads 0.
+// once linked, every allocation in the process goes through here, robots loaded from a .so
+// included. nothing is counted until something asks for it, and then each thread counts into
+// its own counter, so threads never share a cache line.
+
+static std::atomic<int> g_counting(0);
+
+// one per thread that has allocated while counting, linked together without allocating
+struct ThreadAllocations {
+    std::atomic<long long> count;   // only its own thread writes it
+    ThreadAllocations* next;
+    ThreadAllocations();
+    ~ThreadAllocations();
+};
+
+static std::mutex g_threads_lock;
+static ThreadAllocations* g_threads = nullptr;
+static long long g_finished_allocations = 0;   // counted by threads that have since exited
+
+ThreadAllocations::ThreadAllocations() : count(0) {
+    std::lock_guard<std::mutex> lock(g_threads_lock);
+    next = g_threads;
+    g_threads = this;
+}
+
+ThreadAllocations::~ThreadAllocations() {
+    std::lock_guard<std::mutex> lock(g_threads_lock);
+    g_finished_allocations += count.load(std::memory_order_relaxed);
+    ThreadAllocations** link = &g_threads;
+    while (*link != this) {
+        link = &(*link)->next;
+    }
+    *link = next;
+}
+
+static thread_local ThreadAllocations t_allocations;
+
+void* operator new(size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        // a plain load and store, there is only the one writer
+        t_allocations.count.store(t_allocations.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    // as the standard asks, keep calling the new handler until it frees enough or gives up
+    while (true) {
+        void* memory = std::malloc(size);
+        if (memory) {
+            return memory;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+static void set_counting(bool on) {
+    g_counting.fetch_add(on ? 1 : -1, std::memory_order_relaxed);
+}
+
+static long long process_count() {
+    std::lock_guard<std::mutex> lock(g_threads_lock);
+    long long total = g_finished_allocations;
+    for (ThreadAllocations* thread = g_threads; thread; thread = thread->next) {
+        total += thread->count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+static long long thread_count() {
+    return t_allocations.count.load(std::memory_order_relaxed);
+}
+
+// hooks the counter up before main runs. the profiler's side is a plain struct of pointers
+// that starts out zeroed, so it doesn't matter which file's statics are set up first
+static const bool g_installed = (install_allocation_counter(AllocationCounter {set_counting, process_count, thread_count}), true);
@@ -1,215 +1,402 @@
 #include <iostream>
+#include <iomanip>
 #include <fstream>
 #include <string>
 #include <vector>
-#include <dirent.h>
-#include <regex>
 #include <dlfcn.h>
 #include <random>
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <cstring>
+#include <unistd.h>
 
 #include "Arena.h"
+#include "RobotLoader.h"
+#include "Weapons.h"
 
-Arena::Arena() : m_height(10), m_width(10) {
-    m_board.resize(m_height*m_width);
-    for (size_t i = 0; i < m_board.size(); i++) {
-        m_board[i] = '.';
+// the cells of the 3 wide radar ray relative to its center, for each entry in directions[].
+// straight rays spread to both sides, diagonal rays also take the two cells they cut between,
+// so the first step of any ray is the three cells next to the robot on that side.
+// direction 0 has no step and looks at the ring of 8 around the robot.
+struct RadarKernel {
+    int count;
+    std::pair<int, int> offsets[8];
+};
+
+static constexpr RadarKernel make_radar_kernel(int dir) {
+    RadarKernel kernel {};
+    int d_row = directions[dir].first;
+    int d_col = directions[dir].second;
+    if (dir == 0) {
+        kernel.count = 8;
+        for (int i = 0; i < 8; i++) {
+            kernel.offsets[i] = directions[i + 1];
+        }
+    } else if (d_row == 0 || d_col == 0) {
+        kernel.count = 3;
+        kernel.offsets[0] = {0, 0};
+        kernel.offsets[1] = {d_col, d_row};
+        kernel.offsets[2] = {-d_col, -d_row};
+    } else {
+        kernel.count = 3;
+        kernel.offsets[0] = {0, 0};
+        kernel.offsets[1] = {-d_row, 0};
+        kernel.offsets[2] = {0, -d_col};
     }
+    return kernel;
+}
+
+static constexpr RadarKernel RADAR_KERNELS[9] = {
+    make_radar_kernel(0), make_radar_kernel(1), make_radar_kernel(2),
+    make_radar_kernel(3), make_radar_kernel(4), make_radar_kernel(5),
+    make_radar_kernel(6), make_radar_kernel(7), make_radar_kernel(8)
+};
+
+// what a moving robot runs into in each kind of cell, indexed by the cell's character
+enum MoveStep : uint8_t { STEP_CLEAR, STEP_BLOCKED, STEP_PIT, STEP_FLAME };
+
+struct MoveStepTable {
+    uint8_t effects[256];
+};
+
+static constexpr MoveStepTable make_move_steps() {
+    MoveStepTable table {};
+    table.effects[static_cast<unsigned char>('M')] = STEP_BLOCKED;
+    table.effects[static_cast<unsigned char>('R')] = STEP_BLOCKED;
+    table.effects[static_cast<unsigned char>('X')] = STEP_BLOCKED;
+    table.effects[static_cast<unsigned char>('P')] = STEP_PIT;
+    table.effects[static_cast<unsigned char>('F')] = STEP_FLAME;
+    return table;
 }
 
-Arena::Arena(int height, int width) : m_height(height), m_width(width) {
+static constexpr MoveStepTable MOVE_STEPS = make_move_steps();
+
+Arena::Arena() : Arena(10, 10, false) {}
+
+Arena::Arena(int height, int width) : Arena(height, width, false) {}
+
+Arena::Arena(int height, int width, bool headless)
+    : m_height(height), m_width(width), m_headless(headless), m_max_rounds(0), m_mounds(5), m_pits(1), m_flames(9) {
     // load arena config
-    m_board.resize(m_height*m_width);
-    for (size_t i = 0; i < m_board.size(); i++) {
-        m_board[i] = '.';
+    // a fresh seed every time unless set_seed picks one
+    std::random_device device;
+    set_seed((static_cast<uint64_t>(device()) << 32) | device());
+    m_board.reset(m_height*m_width);
+    m_board_index.reset(m_height, m_width);
+    m_board_index_stale = false;
+    m_cell_robot.clear();
+    m_free_left = m_height*m_width;
+    m_live_robots = 0;
+    m_result.winner = -1;
+    m_result.rounds = 0;
+    m_result.seed = m_seed;
+    m_sandboxed = false;
+    m_sandbox_deadline_ms = SANDBOX_DEADLINE_MS;
+    m_turn_budget_us = 0;
+    m_verbosity = LOG_RADAR;
+    m_simultaneous = false;
+    m_decision_threads = 0;
+    m_tile_rows = m_height;
+    m_tile_count = 1;
+    m_wanted_tile_rows = 0;
+    m_profiler.set_enabled(false);
+}
+
+Arena::Arena(const ArenaConfig& config) : Arena(config.height, config.width, !config.watch_live) {
+    set_obstacles(config.mounds, config.pits, config.flames);
+    set_max_rounds(config.max_rounds);
+    if (config.has_seed) {
+        set_seed(config.seed);
+    }
+    set_sandboxed(config.sandbox, config.sandbox_deadline_ms);
+    set_turn_budget(config.turn_budget_us);
+    set_simultaneous(config.simultaneous, config.decision_threads);
+    set_profiling(config.profile || !config.profile_json.empty(), config.profile_json);
+    set_log_path(config.log_file);
+    set_verbosity(config.verbosity);
+}
+
+Arena::~Arena() {
+    // robots have to go before the libraries their code lives in
+    for (size_t i = 0; i < m_robots_list.size(); i++) {
+        delete m_robots_list[i];
+    }
+    for (size_t i = 0; i < m_robots_handles.size(); i++) {
+        dlclose(m_robots_handles[i]);
+    }
+}
+
+void Arena::set_headless(bool headless) {
+    m_headless = headless;
+}
+
+void Arena::set_max_rounds(int max_rounds) {
+    m_max_rounds = max_rounds;
+}
+
+void Arena::set_obstacles(int mounds, int pits, int flames) {
+    m_mounds = mounds;
+    m_pits = pits;
+    m_flames = flames;
+}
+
+void Arena::set_seed(uint64_t seed) {
+    m_seed = seed;
+    m_rng.set_seed(seed);
+}
+
+uint64_t Arena::get_seed() {
+    return m_seed;
+}
+
+void Arena::set_log_path(const std::string& path) {
+    m_log_path = path;
+}
+
+void Arena::open_log() {
+    // the header and robot table let the replay tool draw the board without the robots
+    MatchLogHeader header;
+    std::memcpy(header.magic, MATCH_LOG_MAGIC, sizeof(header.magic));
+    header.height = m_height;
+    header.width = m_width;
+    header.robot_count = m_robots_list.size();
+    header.reserved = 0;
+    header.seed = m_seed;
+    std::vector<MatchLogRobot> robots(m_robots_list.size());
+    for (size_t i = 0; i < m_robots_list.size(); i++) {
+        std::memset(&robots[i], 0, sizeof(MatchLogRobot));
+        std::strncpy(robots[i].name, m_robots_list[i]->m_name.c_str(), sizeof(robots[i].name) - 1);
+        robots[i].character = m_robots_list[i]->m_character;
+        robots[i].weapon = m_robots_list[i]->get_weapon();
     }
+    m_log.open(m_log_path, header, robots);
 }
 
-Arena::~Arena() {}
+void Arena::set_verbosity(int level) {
+    // takes effect at the next match, or straight away through the console log while one is playing
+    m_verbosity = level;
+    if (!m_headless) {
+        m_console.set_level(level);
+    }
+}
+
+void Arena::set_turn_budget(int budget_us) {
+    m_turn_budget_us = budget_us;
+}
+
+void Arena::set_simultaneous(bool simultaneous, int threads) {
+    m_simultaneous = simultaneous;
+    m_decision_threads = threads;
+    m_decision_pool.reset();
+    m_tile_count = 1;
+}
+
+void Arena::set_tile_rows(int rows) {
+    // how tall the tiles of a simultaneous round are, rounded up to whole 64 cell blocks; 0 picks for itself
+    m_wanted_tile_rows = rows;
+}
+
+void Arena::set_profiling(bool profile, const std::string& json_path) {
+    m_profiler.set_enabled(profile);
+    m_profile_json = json_path;
+}
+
+void Arena::set_sandboxed(bool sandboxed, int deadline_ms) {
+    m_sandboxed = sandboxed;
+    m_sandbox_deadline_ms = deadline_ms;
+}
 
 void Arena::load_robots() {
-    std::vector<std::string> uncompiled_robots;
-
-    std::regex pattern("Robot_.*.cpp");
-
-    DIR *dir;
-    struct dirent *ent;
-    
-    if ((dir = opendir("./")) != nullptr) {
-        while ((ent = readdir(dir)) != nullptr) {
-            std::string filename = ent->d_name;
-            if (std::regex_match(filename, pattern)) {
-                uncompiled_robots.push_back(filename);
-            }
-        }
-        closedir(dir);
-    } else {
-        perror("Could not open directory");
-    }
-
-    std::string compile_cmd;
-    std::string filename;
-    std::string shared_lib;
-    for (size_t i = 0; i < uncompiled_robots.size(); i++) {
-        filename = uncompiled_robots[i];
-        shared_lib = filename;
-        size_t pos = shared_lib.rfind(".cpp");
-        shared_lib.replace(pos, 4, ".so");
-        compile_cmd = "g++ -shared -fPIC -o " + shared_lib + " " + filename + " RobotBase.o -I. -std=c++20";
-        std::cout << "Compiling " << filename << " to " << shared_lib << "...\n";
-
-        int compile_result = std::system(compile_cmd.c_str());
-        if (compile_result != 0) 
-        {
-            std::cerr << "Failed to compile " << filename << " with command: " << compile_cmd << std::endl;
-            continue;
-        }
+    // compile every robot up front in parallel (cached builds are reused)
+    // then create one robot from each shared object
+    // the arena keeps the handles and closes them once its robots are gone
+    std::vector<RobotLibrary> libraries = load_robot_libraries("./");
+    for (size_t i = 0; i < libraries.size(); i++) {
+        add_robot_from(libraries[i]);
+        m_robots_handles.push_back(libraries[i].handle);
+    }
+}
 
-        shared_lib = "./" + shared_lib;
-        void* handle = dlopen(shared_lib.c_str(), RTLD_LAZY);
-        if (!handle) 
-        {
-            std::cerr << "Failed to load " << shared_lib << ": " << dlerror() << std::endl;
-            continue;
-        }
+bool Arena::add_robot_from(const RobotLibrary& library) {
+    // makes a robot from the library, in a worker process when the arena is sandboxed
+    RobotBase* robot;
+    if (m_sandboxed) {
+        robot = SandboxedRobot::spawn(library.create_robot, m_sandbox_deadline_ms);
+    } else {
+        robot = library.create_robot();
+    }
+    if (!robot) {
+        std::cerr << "Failed to create robot instance from " << library.name << std::endl;
+        return false;
+    }
+    add_robot(robot, library.name);
+    m_robot_factories.back() = library.create_robot;
+    return true;
+}
 
-        RobotFactory create_robot = (RobotFactory)dlsym(handle, "create_robot");
-        if (!create_robot) 
-        {
-            std::cerr << "Failed to find create_robot in " << shared_lib << ": " << dlerror() << std::endl;
-            dlclose(handle);
-            continue;
-        }
-        
-        RobotBase* robot = create_robot();
-        m_robots_list.push_back(robot);
-        m_robots_handles.push_back(handle);
+void Arena::add_robot(RobotBase* robot, const std::string& name) {
+    // the arena owns the robot from here on
+    // robots that never named themselves get the name of their file
+    // every robot gets its own character on the board
+    if (robot->m_name == "Blank_Robot") {
+        robot->m_name = name;
     }
+    robot->m_character = ROBOT_CHARACTERS[m_robots_list.size() % ROBOT_CHARACTERS.size()];
+    m_robots_list.push_back(robot);
+    m_robot_table.add(robot);
+    m_sandboxes.push_back(dynamic_cast<SandboxedRobot*>(robot));
+    m_robot_factories.push_back(nullptr);
 }
 
 int Arena::random_index() {
-    return std::rand() % (m_height*m_width - 1);
+    return m_rng.below(m_height*m_width);
 }
 
-void Arena::place_obstacles(int mounds, int pits, int flames) {
-    // for each obstacle type while there are some to be placed, choose a random cell
-    // if full choose again, otherwise place ob on board and decrement
-    int cell;
-    int i;
-
-    i = mounds;
-    while (i > 0) {
-        cell = random_index();
-        if (m_board[cell] == '.') {
-            m_board[cell] = 'M';
-            i--;
+int Arena::draw_free_cell() {
+    // a partial Fisher-Yates shuffle of every cell, kept sparse:
+    // slot i holds cell i unless the map says it was swapped
+    // each draw takes a random slot out of the pool and moves the last slot into its place
+    // so every cell comes up at most once and placing k things costs k draws, however full the board is
+    // returns -1 once there is nowhere left
+    while (m_free_left > 0) {
+        int slot = m_rng.below(m_free_left);
+        m_free_left--;
+        std::unordered_map<int, int>::iterator picked = m_free_swaps.find(slot);
+        int cell = picked == m_free_swaps.end() ? slot : picked->second;
+        std::unordered_map<int, int>::iterator moved = m_free_swaps.find(m_free_left);
+        m_free_swaps[slot] = moved == m_free_swaps.end() ? m_free_left : moved->second;
+        if (moved != m_free_swaps.end()) {
+            m_free_swaps.erase(m_free_left);
         }
-    }
-    
-    i = pits;
-    while (i > 0) {
-        cell = random_index();
-        if (m_board[cell] == '.') {
-            m_board[cell] = 'P';
-            i--;
+        // only something put down without a draw can already be here
+        if (!m_board.occupied(cell)) {
+            return cell;
         }
     }
-    
-    i = flames;
-    while (i > 0) {
-        cell = random_index();
-        if (m_board[cell] == '.') {
-            m_board[cell] = 'F';
-            i--;
+    return -1;
+}
+
+void Arena::place_obstacles(int mounds, int pits, int flames) {
+    // for each obstacle type draw that many free cells and place the obstacle on them
+    // the board index is rebuilt once at the end instead of taking every obstacle one at a time
+    const char types[3] = {'M', 'P', 'F'};
+    const int counts[3] = {mounds, pits, flames};
+    m_board_index_stale = true;
+    for (int t = 0; t < 3; t++) {
+        for (int i = 0; i < counts[t]; i++) {
+            int cell = draw_free_cell();
+            if (cell < 0) {
+                std::cerr << "No room left on the board for obstacle " << types[t] << std::endl;
+                t = 3;
+                break;
+            }
+            set_cell(cell, types[t]);
         }
     }
+    m_board_index.rebuild(m_board);
+    m_board_index_stale = false;
 }
 
 void Arena::index_to_pos(int index, int& row, int& col) {
-    (void) row;
     col = index % m_width;
-    row = (index - col) / m_height;
+    row = index / m_width;
 }
 
 void Arena::place_robots() {
-    // for each robot select a random cell
-    // if taken choose again
+    // for each robot draw a free cell
     // place robot on board and set robots position
+    // a robot that doesn't fit is out before it starts
+    m_live_robots = 0;
+    m_board_index_stale = true;
+    // room for every robot up front, so moving them about never rehashes
+    m_cell_robot.reserve(m_robots_list.size());
     for (size_t i = 0; i < m_robots_list.size(); i++) {
-        int cell = random_index();
-        while (m_board[cell] != '.') {
-            cell = random_index();
+        m_robots_list[i]->set_boundaries(m_height, m_width);
+        int cell = draw_free_cell();
+        if (cell < 0) {
+            std::cerr << "No room left on the board for " << m_robots_list[i]->m_name << std::endl;
+            m_robot_table.knock_out(i);
+            m_robot_table.move_to(i, -1, -1);
+            continue;
         }
-        m_board[cell] = 'R';
+        set_cell(cell, 'R');
+        m_cell_robot[cell] = i;
+        m_live_robots++;
         int row = 0;
         int col = 0;
         index_to_pos(cell, row, col);
-        m_robots_list[i]->move_to(row, col);
-        m_robots_list[i]->set_boundaries(m_height, m_width);
+        m_robot_table.move_to(i, row, col);
+        m_log.write(EVENT_PLACE, i, 0, row, col);
     }
+    m_board_index.rebuild(m_board);
+    m_board_index_stale = false;
 }
 
 int Arena::position_to_robot(int row, int col) {
-    // iterates through each robot checking row and col
-    // if matches then return index of robot
+    // looks the cell up in the occupancy index
+    // returns index of the robot there (alive or dead)
     // else return -1
-    int curr_row;
-    int curr_col;
-    for (size_t i = 0; i < m_robots_list.size(); i++) {
-        m_robots_list[i]->get_current_location(curr_row, curr_col);
-        if (curr_row == row && curr_col == col) {
-            return i;
-        }
-    }
-    return -1;
+    return cell_robot(pos_to_index(row, col));
+}
+
+char Arena::cell_at(int row, int col) {
+    // what is on the board at row, col, '.' for nothing
+    return m_board.get(pos_to_index(row, col));
+}
+
+int Arena::cell_robot(int index) {
+    // the robot on the cell at index, alive or dead, -1 if there is none
+    // only reads, so robots deciding side by side can all look cells up at once
+    std::unordered_map<int, int>::const_iterator found = m_cell_robot.find(index);
+    return found == m_cell_robot.end() ? -1 : found->second;
 }
 
 void Arena::display_board() {
-    // displayes the formatted board with each cell as a char
-    // if an R is encountered uses pos to robot to find its char
-    std::cout << std::endl << "   ";
-    for (int cl = 0; cl < m_width; cl++) {
-        if (cl < 10) {
-            std::cout << " " << cl << " ";
-        } else {
-            std::cout << cl << " ";
-        }
+    // fills a frame with every cell and the character of the robot on it
+    // the console log hands it to the renderer, which works out what actually has to be written
+    ScopedTimer timer(m_profiler, PHASE_RENDER);
+    if (!m_console.board_is(m_height, m_width)) {
+        m_console.set_board(m_height, m_width, false);
     }
-    std::cout << std::endl;
+    char* frame = m_console.begin_frame();
     for (int rw = 0; rw < m_height; rw++) {
-        std::cout << rw << "  ";
         for (int cl = 0; cl < m_width; cl++) {
-            char cell = m_board[pos_to_index(rw, cl)];
-            std::cout << " " << cell;
-            if (cell == 'R' && m_robots_list[position_to_robot(rw, cl)]->m_character) {
-                std::cout << m_robots_list[position_to_robot(rw, cl)]->m_character;
-            } else {
-                std::cout << " ";
+            int index = pos_to_index(rw, cl);
+            char cell = m_board.get(index);
+            char robot = ' ';
+            if (cell == 'R') {
+                int owner = cell_robot(index);
+                if (owner >= 0 && m_robots_list[owner]->m_character) {
+                    robot = m_robots_list[owner]->m_character;
+                }
             }
+            frame[index*2] = cell;
+            frame[index*2 + 1] = robot;
         }
-        std::cout << std::endl << std::endl;
     }
+    m_console.end_frame();
 }
 
 bool Arena::is_winner() {
-    // look over all cells and determines if one robot remains
-    // if yes then uses pos to robot to get its name and prints victory
+    // the live robot count is kept up to date by knock_out
+    // if one (or none) remains find it and record it as the winner
     // else return false
-    int row = 0;
-    int col = 0;
-    bool first_time = true;
-    for (size_t i = 0; i < m_board.size(); i++) {
-        if (m_board[i] == 'R') {
-            if (!first_time) {
-                return false;
-            }
-            index_to_pos(i, row, col);
-            first_time = false;
+    if (m_live_robots > 1) {
+        return false;
+    }
+    int winner = -1;
+    for (int i = 0; i < m_robot_table.size(); i++) {
+        if (m_robot_table.alive(i)) {
+            winner = i;
+            break;
         }
     }
-    std::cout << "End of game! " << m_robots_list[position_to_robot(row, col)]->m_name << " Wins!!!" << std::endl;
+    m_result.winner = winner;
+    m_console.push(CONSOLE_WINNER, winner);
     return true;
 }
 
@@ -218,640 +405,1176 @@ int Arena::pos_to_index(int row, int col) {
 }
 
 bool Arena::pos_in_bounds(int row, int col) {
-    return (row > 0 && row < m_height) && (col > 0 && col < m_width);
-}
-
-std::vector<RadarObj> Arena::scan_radar(int dir, int start_row, int start_col) {
-    // switch on direction for iteration loop params and kernal shape
-    // iterate kernal one away from robot and check all kernal cells for radobj
-    // for each scan add to vec
-    // continue scan until all kernal cells are out of bounds
-    // return vec
-    std::vector<RadarObj> scanned_objects;
-    bool in;
-    int row;
-    int col;
-    switch (dir) {
-        case 0:
-            // all around
-            row = start_row;
-            col = start_col;
-            while (true) {
-                in = false;
-                // top right
-                if (pos_in_bounds(row+1, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col=1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col=1});
-                }
-                // middle right
-                if (pos_in_bounds(row, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col+1});
-                }
-                // bottom right
-                if (pos_in_bounds(row-1, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col+1});
-                }
-                // bottom middle
-                if (pos_in_bounds(row-1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col});
-                }
-                // bottom left
-                if (pos_in_bounds(row-1, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col-1});
-                }
-                // middle left
-                if (pos_in_bounds(row, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col-1});
-                }
-                // top left
-                if (pos_in_bounds(row+1, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col-1});
-                }
-                // top middle
-                if (pos_in_bounds(row+1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col});
-                }
-                row++;
-            }
-            break;
-        case 1:
-            // up
-            row = start_row + 1;
-            col = start_col;
-            while (true) {
-                in = false;
-                // middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // left
-                if (pos_in_bounds(row, col-1)) {
-                    in =true;
-                    char cell = m_board[pos_to_index(row, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col-1});
-                }
-                // right
-                if (pos_in_bounds(row, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col+1});
-                }
-                if (!in) {
-                    break;
-                }
-                row++;
-            }
-            break;
-        case 2:
-            // up right
-            row = start_row + 1;
-            col = start_col + 1;
-            while (true) {
-                in = false;
-                // top left
-                if (pos_in_bounds(row+1, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col-1});
-                }
-                // top middle
-                if (pos_in_bounds(row+1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col});
-                }
-                // middle middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // middle right
-                if (pos_in_bounds(row, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col+1});
-                }
-                // bottom right
-                if (pos_in_bounds(row-1, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col+1});
-                }
-                if (!in) {
-                    break;
-                }
-                row++;
-                col++;
-            }
-            break;
-        case 3:
-            // right
-            row = start_row;
-            col = start_col + 1;
-            while (true) {
-                in = false;
-                // middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // bottom
-                if (pos_in_bounds(row-1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col});
-                }
-                // top
-                if (pos_in_bounds(row+1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col});
-                }
-                if (!in) {
-                    break;
-                }
-                col++;
-            }
-            break;
-        case 4:
-            // down right
-            row = start_row - 1;
-            col = start_col + 1;
-            while (true) {
-                in = false;
-                // top right
-                if (pos_in_bounds(row+1, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col+1});
-                }
-                // middle right
-                if (pos_in_bounds(row, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col+1});
-                }
-                // middle middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // bottom middle
-                if (pos_in_bounds(row-1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col});
-                }
-                // bottom left
-                if (pos_in_bounds(row-1, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col-1});
-                }
-                if (!in) {
-                    break;
-                }
-                row--;
-                col++;
-            }
-            break;
-        case 5:
-            // down
-            row = start_row - 1;
-            col = start_col;
-            while (true) {
-                in = false;
-                // middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // left
-                if (pos_in_bounds(row, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col-1});
-                }
-                // right
-                if (pos_in_bounds(row, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col+1});
-                }
-                if (!in) {
-                    break;
-                }
-                row--;
-            }
-            break;
-        case 6:
-            // down left
-            row = start_row - 1;
-            col = start_col - 1;
-            while (true) {
-                in = false;
-                // bottom right
-                if (pos_in_bounds(row-1, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col+1});
-                }
-                // bottom middle
-                if (pos_in_bounds(row-1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col});
-                }
-                // middle middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // middle left
-                if (pos_in_bounds(row, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col-1});
-                }
-                // top left
-                if (pos_in_bounds(row+1, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col-1});
-                }
-                if (!in) {
-                    break;
-                }
-                row--;
-                col--;
-            }
-            break;
-        case 7:
-            // left
-            row = start_row;
-            col = start_col - 1;
-            while (true) {
-                in = false;
-                // middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // bottom
-                if (pos_in_bounds(row-1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col});
-                }
-                // top
-                if (pos_in_bounds(row+1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col});
-                }
-                if (!in) {
-                    break;
+    return (row >= 0 && row < m_height) && (col >= 0 && col < m_width);
+}
+
+void Arena::clip_ray(int start, int step, int size, int& first, int& last) {
+    // narrows [first, last] to the k where start + k*step is in [0, size)
+    // step is -1, 0 or 1
+    if (step == 0) {
+        if (start < 0 || start >= size) {
+            last = 0;
+        }
+    } else if (step > 0) {
+        first = std::max(first, -start);
+        last = std::min(last, size - 1 - start);
+    } else {
+        first = std::max(first, start - size + 1);
+        last = std::min(last, start);
+    }
+}
+
+const std::vector<RadarObj>& Arena::scan_radar(int dir, int start_row, int start_col) {
+    // results go into the arena's buffer, which is reused scan after scan
+    scan_radar(dir, start_row, start_col, m_radar_results);
+    return m_radar_results;
+}
+
+int Arena::scan_radar(int dir, int start_row, int start_col, std::vector<RadarObj>& results) {
+    // the ray is three lines: center + offset + k*step for k = 1, 2, ...
+    // each line is clipped to the board once, up front, to the k range it stays inside
+    // the board index then gives just the objects on that stretch of each line
+    // and the lines are merged by step so results come out nearest first
+    // only reads the board, so robots deciding side by side can all scan at once
+    // returns how many cells the ray covers
+    results.clear();
+    if (dir < 0 || dir > 8) {
+        return 0;
+    }
+    const RadarKernel& kernel = RADAR_KERNELS[dir];
+    int d_row = directions[dir].first;
+    int d_col = directions[dir].second;
+
+    if (dir == 0) {
+        // the ring of 8 is small enough to just read
+        int covered = 0;
+        for (int o = 0; o < kernel.count; o++) {
+            int row = start_row + kernel.offsets[o].first;
+            int col = start_col + kernel.offsets[o].second;
+            if (pos_in_bounds(row, col)) {
+                covered++;
+                if (m_board.occupied(pos_to_index(row, col))) {
+                    results.push_back(RadarObj {m_board.get(pos_to_index(row, col)), row, col});
                 }
-                col--;
             }
-            break;
-        case 8:
-            // up left
-            row = start_row + 1;
-            col = start_col - 1;
-            while (true) {
-                in = false;
-                // bottom left
-                if (pos_in_bounds(row-1, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row-1, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row-1, col-1});
-                }
-                // middle left
-                if (pos_in_bounds(row, col-1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col-1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col-1});
-                }
-                // middle middle
-                if (pos_in_bounds(row, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row, col});
-                }
-                // top middle
-                if (pos_in_bounds(row+1, col)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col});
-                }
-                // top right
-                if (pos_in_bounds(row+1, col+1)) {
-                    in = true;
-                    char cell = m_board[pos_to_index(row+1, col+1)];
-                    if (cell != '.') scanned_objects.push_back(RadarObj {cell, row+1, col+1});
-                }
-                if (!in) {
-                    break;
-                }
-                row++;
-                col--;
+        }
+        return covered;
+    }
+
+    // along a row the position on the line is the column, on every other line it is the row
+    // rows are searched a word at a time on the bit board, the other lines come from the board index
+    int sign = d_row != 0 ? d_row : d_col;
+    const std::vector<int>* lines[3];
+    int row_start[3];
+    int base[3];
+    int low[3];
+    int high[3];
+    int at[3];
+    int end[3];
+    int step[3];    // steps out to the next object on the line, 0 once there are none left
+    int covered = 0;
+    for (int o = 0; o < kernel.count; o++) {
+        int row = start_row + kernel.offsets[o].first;
+        int col = start_col + kernel.offsets[o].second;
+        int first = 1;
+        int last = m_height + m_width;
+        clip_ray(row, d_row, m_height, first, last);
+        clip_ray(col, d_col, m_width, first, last);
+        lines[o] = nullptr;
+        step[o] = 0;
+        if (first > last) {
+            continue;
+        }
+        covered += last - first + 1;
+        if (d_row == 0) {
+            base[o] = col;
+            row_start[o] = pos_to_index(row, 0);
+        } else {
+            lines[o] = &m_board_index.find_line(row, col, d_row, d_col, base[o]);
+        }
+        low[o] = base[o] + (sign > 0 ? first : -last);
+        high[o] = base[o] + (sign > 0 ? last : -first);
+        if (lines[o]) {
+            const std::vector<int>& cells = *lines[o];
+            int low_at = std::lower_bound(cells.begin(), cells.end(), low[o]) - cells.begin();
+            int high_at = std::upper_bound(cells.begin(), cells.end(), high[o]) - cells.begin();
+            at[o] = sign > 0 ? low_at : high_at - 1;
+            end[o] = sign > 0 ? high_at : low_at - 1;
+            step[o] = at[o] != end[o] ? (cells[at[o]] - base[o]) * sign : 0;
+        } else {
+            int found = sign > 0 ? m_board.find_first_occupied(row_start[o] + low[o], row_start[o] + high[o])
+                                 : m_board.find_last_occupied(row_start[o] + low[o], row_start[o] + high[o]);
+            step[o] = found < 0 ? 0 : (found - row_start[o] - base[o]) * sign;
+        }
+    }
+
+    while (true) {
+        // next object is the one fewest steps out, ties go by kernel order
+        int best = -1;
+        for (int o = 0; o < kernel.count; o++) {
+            if (step[o] > 0 && (best < 0 || step[o] < step[best])) {
+                best = o;
             }
+        }
+        if (best < 0) {
             break;
-        default:
-            break;
+        }
+        int k = step[best];
+        int row = start_row + kernel.offsets[best].first + k*d_row;
+        int col = start_col + kernel.offsets[best].second + k*d_col;
+        results.push_back(RadarObj {m_board.get(pos_to_index(row, col)), row, col});
+
+        // move that line on past the object just reported
+        if (lines[best]) {
+            at[best] += sign;
+            step[best] = at[best] != end[best] ? ((*lines[best])[at[best]] - base[best]) * sign : 0;
+        } else {
+            int next = base[best] + (k + 1)*sign;
+            int found = sign > 0 ? m_board.find_first_occupied(row_start[best] + next, row_start[best] + high[best])
+                                 : m_board.find_last_occupied(row_start[best] + low[best], row_start[best] + next);
+            step[best] = found < 0 ? 0 : (found - row_start[best] - base[best]) * sign;
+        }
     }
-    return scanned_objects;
-}
-
-void Arena::handle_shot(WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col) {
-    (void) aim_row;
-    (void) aim_col;
-    (void) start_row;
-    (void) start_col;
-    // iterates through all affected weapon cells
-    // for each robot encountered finds its index with pos to robot
-    // it then calls do damage
-    switch (weapon) {
-        case flamethrower:
-            // 30-50 dp, 4 long, 3 wide ray
-            // ???
-            break;
-        case railgun:
-		{
-			int del_row = aim_row - start_row;
-			int del_col = aim_col - start_col;
-
-			int steps = std::max(std::abs(del_row), std::abs(del_col));
-			if (steps == 0) break;
-
-			double row_inc = del_row / double(steps);
-			double col_inc = del_col / double(steps);
-
-			double row_counter = start_row;
-			double col_counter = start_col;
-
-			row_counter += row_inc;
-			col_counter += col_inc;
-
-			while (true)
-			{
-				int r = static_cast<int>(std::round(row_counter));
-				int c = static_cast<int>(std::round(col_counter));
-
-				if (!pos_in_bounds(r, c)) break;
-
-				if (m_board[pos_to_index(r, c)] == 'R') {
-					do_damage(10, 20, position_to_robot(r, c));
-				}
-
-				row_counter += row_inc;
-				col_counter += col_inc;
-			}
-			break;
-		}
-			break;
-        case grenade:
-            // 10-40 dp, 3x3 area anywhere
-            // ???
-            break;
-        case hammer:
-		{
-			int del_row = aim_row - start_row;
-			int del_col = aim_col - start_col;
-
-			int steps = std::max(std::abs(del_row), std::abs(del_col));
-			if (steps == 0) break;
-
-			double row_inc = del_row / double(steps);
-			double col_inc = del_col / double(steps);
-
-			int r = static_cast<int>(std::round(start_row + row_inc));
-			int c = static_cast<int>(std::round(start_col + col_inc));
-
-			if (pos_in_bounds(r, c) && m_board[pos_to_index(r, c)] == 'R') {
-				do_damage(50, 60, position_to_robot(r, c));
-			}
-			break;
-		}
-			break;
-    }
-
-    std::cout << "\tdid not deal damage" << std::endl << std::endl;
-}
-
-void Arena::do_damage(int low_damage, int high_damage, int robot) {
-    // calculates damage from range
-    // finds robot at index
-    // decreases health based on damage calculated and sheilds
-    // decrements robots shield
-    // if robot dies updates board
-    int damage = low_damage + std::rand() % (high_damage - low_damage + 1);
-    double block_percent = m_robots_list[robot]->get_armor() * 0.1;
-    damage = (damage - damage*block_percent) / 1;
-    int health = m_robots_list[robot]->get_health();
-    if (damage >= health) {
-        m_robots_list[robot]->take_damage(health);
-        m_robots_list[robot]->disable_movement();
+    return covered;
+}
+
+void Arena::robot_radar(int robot, int dir, std::vector<RadarObj>& results) {
+    // robot's radar scan from where it stands, timed and counted against it
+    ScopedTimer timer(m_profiler, PHASE_RADAR, robot);
+    int covered = scan_radar(dir, m_robot_table.row(robot), m_robot_table.col(robot), results);
+    m_profiler.count(COUNT_CELLS_SCANNED, robot, covered);
+    m_profiler.count(COUNT_RADAR_OBJECTS, robot, results.size());
+}
+
+void Arena::set_cell(int index, char type) {
+    // every board write goes through here so the board index never falls behind
+    // (while placing a crowd the index is left alone and rebuilt once afterwards)
+    bool was_empty = !m_board.occupied(index);
+    m_board.set(index, type);
+    publish_cell(index, type, was_empty);
+}
+
+void Arena::publish_cell(int index, char type, bool was_empty) {
+    // logs a cell write and keeps the board index up with it
+    // tiles write their cells straight into the bit board and publish them here once they are done
+    if (m_log.is_open()) {
         int row;
         int col;
-        m_robots_list[robot]->get_current_location(row, col);
-        m_board[pos_to_index(row, col)] = 'X';
+        index_to_pos(index, row, col);
+        m_log.write(EVENT_CELL, -1, type, row, col);
+    }
+    if (!m_board_index_stale && was_empty != (type == '.')) {
+        int row;
+        int col;
+        index_to_pos(index, row, col);
+        if (was_empty) {
+            m_board_index.insert(row, col);
+        } else {
+            m_board_index.erase(row, col);
+        }
+    }
+}
+
+void Arena::shot_targets(WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col, std::vector<int>& cells, std::vector<int>& targets) {
+    // the weapon works out which cells the shot covers
+    // the occupancy index says which live robot is standing in each, those get appended to targets
+    // only reads the board, so the robots of a simultaneous round can all work out their shots at once
+    cells.clear();
+    shot_cells(weapon, start_row, start_col, aim_row, aim_col, m_height, m_width, cells);
+    for (int cell : cells) {
+        if (m_board.test(PLANE_ROBOT, cell)) {
+            targets.push_back(cell_robot(cell));
+        }
+    }
+}
+
+bool Arena::queue_shot(int shooter, WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col) {
+    // queues a damage roll for every robot the shot hits
+    // returns false for a grenade launcher with no grenades left, which doesn't fire
+    ScopedTimer timer(m_profiler, PHASE_SHOTS, shooter);
+    if (weapon == grenade) {
+        if (m_robot_table.grenades(shooter) <= 0) {
+            return false;
+        }
+        m_robot_table.use_grenade(shooter);
+    }
+    m_shot_targets.clear();
+    shot_targets(weapon, aim_row, aim_col, start_row, start_col, m_shot_cells, m_shot_targets);
+    for (int target : m_shot_targets) {
+        queue_damage(WEAPON_DAMAGE[weapon].low, WEAPON_DAMAGE[weapon].high, target, shooter);
+    }
+    return true;
+}
+
+void Arena::report_shot(int shooter, const std::vector<PendingDamage>& hits, size_t& next) {
+    // prints the resolved hits from next on that the shooter made, leaving next past them
+    int count = 0;
+    for (; next < hits.size() && hits[next].attacker == shooter; next++) {
+        if (hits[next].damage >= 0) {
+            m_console.push(CONSOLE_HIT, hits[next].robot, 0, hits[next].damage);
+            count++;
+        }
+    }
+    m_console.push(CONSOLE_SHOT_END, shooter, 0, count);
+    m_profiler.count(COUNT_SHOTS, shooter);
+    m_profiler.count(COUNT_HITS, shooter, count);
+}
+
+void Arena::handle_shot(int shooter, WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col) {
+    // one shot on its own, resolved as soon as it is fired
+    m_pending_damage.clear();
+    if (!queue_shot(shooter, weapon, aim_row, aim_col, start_row, start_col)) {
+        m_console.push(CONSOLE_NO_GRENADES, shooter);
+        return;
+    }
+    resolve_damage();
+    size_t next = 0;
+    report_shot(shooter, m_pending_damage, next);
+}
+
+void Arena::queue_damage(int low_damage, int high_damage, int robot, int attacker) {
+    // rolls the damage now so the rolls come in the order things were hit
+    // attacker is the robot that dealt the damage, -1 for the arena itself
+    int sequence = m_pending_damage.size();
+    int roll = m_rng.range(low_damage, high_damage);
+    m_pending_damage.push_back(PendingDamage {robot, attacker, roll, roll, sequence, 0, 0});
+}
+
+// one hit against a robot's health and armor: every point of armor blocks 10% of it, and a hit
+// that doesn't kill wears a point off the armor. returns the damage that got through
+static int apply_hit(int damage, int& health, int& armor) {
+    double block_percent = armor * 0.1;
+    int through = (damage - damage*block_percent) / 1;
+    if (through >= health) {
+        through = health;
+        health = 0;
+    } else {
+        health -= through;
+        armor = std::max(armor - 1, 0);
+    }
+    return through;
+}
+
+void Arena::resolve_damage() {
+    // applies the queued damage in one pass, a robot at a time
+    // the hits are sorted by robot, each robot's in the order they were rolled, and cut into one run per robot
+    // with more than one tile each run is resolved by the worker that owns the tile its robot stands on,
+    // then every run is published in robot order, so the log and the totals come out as they would on one thread
+    // each record is left holding the damage that got through, -1 if it was dropped
+    ScopedTimer timer(m_profiler, PHASE_DAMAGE);
+    std::sort(m_pending_damage.begin(), m_pending_damage.end(), [](const PendingDamage& a, const PendingDamage& b) {
+        return a.robot != b.robot ? a.robot < b.robot : a.sequence < b.sequence;
+    });
+    int count = m_pending_damage.size();
+    m_hit_runs.clear();
+    for (int i = 0; i < count; i++) {
+        if (i == 0 || m_pending_damage[i].robot != m_pending_damage[i - 1].robot) {
+            m_hit_runs.push_back(i);
+        }
+    }
+    m_hit_runs.push_back(count);
+    int runs = m_hit_runs.size() - 1;
+    if (m_tile_count > 1 && runs > 1) {
+        for (std::vector<int>& jobs : m_tile_jobs) {
+            jobs.clear();
+        }
+        for (int r = 0; r < runs; r++) {
+            int robot = m_pending_damage[m_hit_runs[r]].robot;
+            m_tile_jobs[tile_of_row(m_robot_table.row(robot))].push_back(r);
+        }
+        m_decision_pool->parallel_for(m_tile_count, [this](size_t tile) {
+            for (int r : m_tile_jobs[tile]) {
+                resolve_hits(m_pending_damage, m_hit_runs[r], m_hit_runs[r + 1]);
+            }
+        });
     } else {
-        m_robots_list[robot]->take_damage(damage);
-        m_robots_list[robot]->reduce_armor(1);
+        for (int r = 0; r < runs; r++) {
+            resolve_hits(m_pending_damage, m_hit_runs[r], m_hit_runs[r + 1]);
+        }
     }
+    for (int r = 0; r < runs; r++) {
+        publish_hits(m_pending_damage, m_hit_runs[r], m_hit_runs[r + 1]);
+    }
+}
+
+void Arena::resolve_hits(std::vector<PendingDamage>& hits, int first, int last) {
+    // applies hits[first, last), all on one robot, in order
+    // its health and armor are read once, every hit is cut down by the armor and wears a point off it,
+    // then they are written back once. a robot that dies is left an X on the bit board, hits after that are dropped
+    // only the robot, its cell and its own records are touched, so robots on different tiles resolve side by side
+    int robot = hits[first].robot;
+    int start_health = m_robot_table.health(robot);
+    int start_armor = m_robot_table.armor(robot);
+    int health = start_health;
+    int armor = start_armor;
+    for (int i = first; i < last; i++) {
+        PendingDamage& hit = hits[i];
+        if (health == 0) {
+            hit.damage = -1;
+            continue;
+        }
+        hit.damage = apply_hit(hit.roll, health, armor);
+        hit.health = health;
+        hit.armor = armor;
+        m_damage_taken[robot] += hit.damage;
+    }
+    // a robot the last hit kills keeps the armor the hits before it wore off
+    m_robot_table.damage(robot, start_health - health, start_armor - armor);
+    if (health == 0) {
+        m_robot_table.knock_out(robot);
+        m_board.set(pos_to_index(m_robot_table.row(robot), m_robot_table.col(robot)), 'X');
+    }
+}
+
+void Arena::publish_hits(const std::vector<PendingDamage>& hits, int first, int last) {
+    // logs the resolved hits[first, last) on one robot and credits whoever dealt them,
+    // then its death if they killed it
+    bool killed = false;
+    for (int i = first; i < last; i++) {
+        const PendingDamage& hit = hits[i];
+        if (hit.damage < 0) {
+            continue;
+        }
+        m_log.write(EVENT_HIT, hit.robot, 0, hit.attacker, hit.roll);
+        // the damage goes in the log ahead of the death it causes
+        m_log.write(EVENT_DAMAGE, hit.robot, 0, hit.attacker, hit.damage, hit.health, hit.armor);
+        if (hit.attacker >= 0 && hit.attacker != hit.robot) {
+            m_damage_dealt[hit.attacker] += hit.damage;
+        }
+        killed = hit.health == 0;
+    }
+    if (killed) {
+        publish_death(hits[first].robot);
+    }
+}
+
+void Arena::knock_out(int robot) {
+    // takes the rest of the robot's health, stops it moving and leaves it on the board as an X
+    m_robot_table.knock_out(robot);
+    m_board.set(pos_to_index(m_robot_table.row(robot), m_robot_table.col(robot)), 'X');
+    publish_death(robot);
 }
 
-void Arena::move_robot(int start_row, int start_col, int dir, int speed) {
-    // steps through motion up to speed steps in dir
-    // if obstacle encountered handled accordingly
-    // updates board
-    // updates robot position
+void Arena::publish_death(int robot) {
+    // logs a robot already knocked out, its X and the death, and takes it off the live count
+    int row = m_robot_table.row(robot);
+    int col = m_robot_table.col(robot);
+    publish_cell(pos_to_index(row, col), 'X', false);
+    m_live_robots--;
+    m_log.write(EVENT_DEATH, robot, 0, row, col);
+}
+
+bool Arena::time_callback(int robot, std::chrono::steady_clock::time_point call_start, int64_t& turn_ns) {
+    // records how long the callback that began at call_start took and adds it to the turn total
+    // returns false once the robot's calls this turn have gone over the budget
+    // (the arena's own work between the calls is not held against the robot)
+    int64_t took = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - call_start).count();
+    m_latencies[robot].push_back(took);
+    if (m_profiler.enabled()) {
+        m_profiler.add_time(PHASE_CALLBACKS, robot, took);
+    }
+    turn_ns += took;
+    return m_turn_budget_us <= 0 || turn_ns <= m_turn_budget_us * 1000LL;
+}
+
+int Arena::move_reach(const MoveOrder& order, int& d_row, int& d_col) {
+    // the cells the robot could cross along directions[dir]: its distance cut down to its speed,
+    // then to the edge of the board. d_row and d_col are left holding the step
+    d_row = 0;
+    d_col = 0;
+    if (order.dir >= 1 && order.dir <= 8) {
+        d_row = directions[order.dir].first;
+        d_col = directions[order.dir].second;
+    }
+    int robot = order.robot;
+    int first = 1;
+    int last = d_row == 0 && d_col == 0 ? 0 : std::min(order.distance, m_robot_table.move(robot));
+    clip_ray(m_robot_table.row(robot), d_row, m_height, first, last);
+    clip_ray(m_robot_table.col(robot), d_col, m_width, first, last);
+    return last;
+}
+
+void Arena::walk_move(MoveOrder& order, MoveWork& work, bool rolled) {
+    // walks the robot up to its speed along directions[dir] until something stops it
+    // the path is clipped to the board up front and what each cell does to a robot comes from MOVE_STEPS,
+    // so the loop is a table lookup per cell
+    // mounds and other robots stop it short, a pit stops it for good, flames burn it on the way through
+    // and it never comes to rest on a flame, it stops short of that too
+    // a flame that burns it out ends the walk there, so it is left short of that flame
+    // the flames go in m_move_hits from work.first_hit on, rolled already if rolled is set, else rolled here
+    // only the robot, its own records and the cells it could reach are touched; the log, the board index
+    // and the occupancy map wait for publish_move, so moves that reach no common cell can walk side by side
+    int robot = order.robot;
+    ScopedTimer timer(m_profiler, PHASE_MOVES, robot);
+    m_profiler.count(COUNT_MOVES, robot);
     int d_row;
     int d_col;
-    int dist = speed;
-    int row = start_row;
-    int col = start_col;
-    switch (dir) {
-        case 1:
-            // up
-            d_row = 1;
-            d_col = 0;
-            break;
-        case 2:
-            // up right
-            d_row = 1;
-            d_col = 1;
-            break;
-        case 3:
-            // right
-            d_row = 0;
-            d_col = 1;
-            break;
-        case 4:
-            // down right
-            d_row = -1;
-            d_col = 1;
-            break;
-        case 5:
-            // down
-            d_row = -1;
-            d_col = 0;
-            break;
-        case 6:
-            // down left
-            d_row = -1;
-            d_col = -1;
-            break;
-        case 7:
-            // left
-            d_row = 0;
-            d_col = -1;
-            break;
-        case 8:
-            // up left
-            d_row = 1;
-            d_col = -1;
-            break;
-        default:
-            d_row = 0;
-            d_col = 0;
-    }
-    int max_speed = m_robots_list[position_to_robot(start_row, start_col)]->get_move_speed();
-    if (speed > max_speed) {
-        dist = max_speed;
-    }
-    for (int d = 0; d < dist; d++) {
-        row += d_row;
-        col += d_col;
-        if (!pos_in_bounds(row, col)) {
-            row -= d_row;
-            col -= d_col;
+    int last = move_reach(order, d_row, d_col);
+    int step = d_row*m_width + d_col;
+    int start = pos_to_index(m_robot_table.row(robot), m_robot_table.col(robot));
+    int index = start;
+    int start_health = m_robot_table.health(robot);
+    int start_armor = m_robot_table.armor(robot);
+    int health = start_health;
+    int armor = start_armor;
+    work.hits = 0;
+    for (int k = 1; k <= last; k++) {
+        uint8_t effect = MOVE_STEPS.effects[static_cast<unsigned char>(m_board.get(index + step))];
+        if (effect == STEP_BLOCKED) {
             break;
         }
-        char cell = m_board[pos_to_index(row, col)];
-        if (cell == 'M' || cell == 'R' || cell == 'X') {
-            row -= d_row;
-            col -= d_col;
-            break;
-        } 
-        else if (cell == 'P') {
-            m_robots_list[position_to_robot(start_row, start_col)]->disable_movement();
+        index += step;
+        if (effect == STEP_PIT) {
+            m_robot_table.disable_movement(robot);
             break;
         }
-        else if (cell == 'F') {
-            do_damage(30, 50, position_to_robot(start_row, start_col));
+        if (effect == STEP_FLAME) {
+            PendingDamage& hit = m_move_hits[work.first_hit + work.hits];
+            if (!rolled) {
+                hit.roll = m_rng.range(30, 50);
+            }
+            hit.robot = robot;
+            hit.attacker = -1;
+            hit.sequence = work.hits;
+            hit.damage = apply_hit(hit.roll, health, armor);
+            hit.health = health;
+            hit.armor = armor;
+            m_damage_taken[robot] += hit.damage;
+            work.hits++;
+            if (health == 0) {
+                break;
+            }
         }
     }
-    if (m_board[pos_to_index(row, col)] == 'F') {
-        row -= d_row;
-        col -= d_col;
+    while (index != start && m_board.test(PLANE_FLAME, index)) {
+        index -= step;
+    }
+    index_to_pos(index, order.row, order.col);
+    m_robot_table.move_to(robot, order.row, order.col);
+    work.start = start;
+    work.entered_empty = !m_board.occupied(index);
+    if (index != start) {
+        m_board.set(start, '.');
+        m_board.set(index, 'R');
     }
-    m_robots_list[position_to_robot(start_row, start_col)]->move_to(row, col);
-    m_board[pos_to_index(start_row, start_col)] = '.';
-    m_board[pos_to_index(row, col)] = 'R';
-    std::cout << "\tmoving to (" << row << "," << col << ")" << std::endl << std::endl;
+    // flames crossed on the way burn once the robot has landed, so one burnt out is left where it stopped
+    m_robot_table.damage(robot, start_health - health, start_armor - armor);
+    if (health == 0) {
+        m_robot_table.knock_out(robot);
+        m_board.set(index, 'X');
+    }
+    order.moved = true;
 }
 
-int Arena::game_loop() {
-    // on startup
-    // load robots
-    load_robots();
+void Arena::publish_move(const MoveOrder& order, const MoveWork& work) {
+    // logs a walked move and catches the board index and the occupancy map up with it,
+    // in the order one walk after another would have: the move, the cells, the flames, then any death
+    int robot = order.robot;
+    int start_row;
+    int start_col;
+    index_to_pos(work.start, start_row, start_col);
+    m_log.write(EVENT_MOVE, robot, 0, start_row, start_col, order.row, order.col);
+    int index = pos_to_index(order.row, order.col);
+    if (index != work.start) {
+        publish_cell(work.start, '.', false);
+        publish_cell(index, 'R', work.entered_empty);
+        // the robot's entry is moved across to its new cell rather than freed and made again
+        std::unordered_map<int, int>::node_type entry = m_cell_robot.extract(work.start);
+        entry.key() = index;
+        m_cell_robot.insert(std::move(entry));
+    }
+    publish_hits(m_move_hits, work.first_hit, work.first_hit + work.hits);
+}
+
+void Arena::move_robot(MoveOrder& order) {
+    // one move on its own, its flames rolled as it crosses them, and published straight away
+    int d_row;
+    int d_col;
+    size_t reach = std::max(move_reach(order, d_row, d_col), 0);
+    if (m_move_hits.size() < reach) {
+        m_move_hits.resize(reach);
+    }
+    MoveWork work;
+    work.first_hit = 0;
+    walk_move(order, work, false);
+    publish_move(order, work);
+}
+
+void Arena::move_robots(std::vector<MoveOrder>& orders) {
+    // plays out a batch of moves as if in order, each one seeing the board the ones before it left
+    // a robot that is out by the time its order comes up stays where it is
+    // every flame roll the batch could need is drawn up front, a slot per cell each move could reach,
+    // so which thread walks a move can't change the rolls it gets
+    // with more than one tile the moves are walked on the tiles: see group_moves. moves that share no cell
+    // end the same whichever walks first, so this ends as walking every move in order would
+    // after that every move is published in order
+    int count = orders.size();
+    m_move_work.resize(count);
+    int rolls = 0;
+    for (int m = 0; m < count; m++) {
+        MoveOrder& order = orders[m];
+        MoveWork& work = m_move_work[m];
+        order.moved = false;
+        work.reach = -1;
+        work.first_hit = rolls;
+        work.hits = 0;
+        if (m_robot_table.alive(order.robot)) {
+            int d_row;
+            int d_col;
+            work.reach = std::max(move_reach(order, d_row, d_col), 0);
+            int row = m_robot_table.row(order.robot);
+            int col = m_robot_table.col(order.robot);
+            work.top = std::min(row, row + d_row*work.reach);
+            work.bottom = std::max(row, row + d_row*work.reach);
+            work.left = std::min(col, col + d_col*work.reach);
+            work.right = std::max(col, col + d_col*work.reach);
+            rolls += work.reach;
+        }
+    }
+    if ((int)m_move_hits.size() < rolls) {
+        m_move_hits.resize(rolls);
+    }
+    for (int r = 0; r < rolls; r++) {
+        m_move_hits[r].roll = m_rng.range(30, 50);
+    }
+    if (m_tile_count > 1 && count > 1) {
+        group_moves(orders);
+        m_decision_pool->parallel_for(m_tile_count, [this, &orders](size_t tile) {
+            for (int m : m_tile_jobs[tile]) {
+                walk_move(orders[m], m_move_work[m], true);
+            }
+        });
+        for (int m : m_edge_jobs) {
+            walk_move(orders[m], m_move_work[m], true);
+        }
+    } else {
+        for (int m = 0; m < count; m++) {
+            if (m_move_work[m].reach >= 0) {
+                walk_move(orders[m], m_move_work[m], true);
+            }
+        }
+    }
+    for (int m = 0; m < count; m++) {
+        if (orders[m].moved) {
+            publish_move(orders[m], m_move_work[m]);
+        }
+    }
+}
+
+// the root of a move's group, halving the path on the way up
+static int group_root(std::vector<MoveWork>& work, int m) {
+    while (work[m].group != m) {
+        work[m].group = work[work[m].group].group;
+        m = work[m].group;
+    }
+    return m;
+}
+
+void Arena::group_moves(const std::vector<MoveOrder>& orders) {
+    // hands the batch's moves to the tiles. moves whose boxes (the cells each could reach) overlap are
+    // grouped, swept in order of top row so only boxes that start before another ends are compared
+    // a group whose boxes all lie in one tile is walked by that tile's worker, in order
+    // a group that crosses a tile edge goes to m_edge_jobs and is walked on this thread once the tiles are done;
+    // that is the exchange between tiles, and the only place moves from two tiles meet
+    int count = orders.size();
+    m_move_sweep.clear();
+    for (int m = 0; m < count; m++) {
+        m_move_work[m].group = m;
+        if (m_move_work[m].reach >= 0) {
+            m_move_sweep.push_back(m);
+        }
+    }
+    std::sort(m_move_sweep.begin(), m_move_sweep.end(), [this](int a, int b) {
+        return m_move_work[a].top != m_move_work[b].top ? m_move_work[a].top < m_move_work[b].top : a < b;
+    });
+    for (size_t a = 0; a < m_move_sweep.size(); a++) {
+        const MoveWork& box = m_move_work[m_move_sweep[a]];
+        for (size_t b = a + 1; b < m_move_sweep.size() && m_move_work[m_move_sweep[b]].top <= box.bottom; b++) {
+            const MoveWork& other = m_move_work[m_move_sweep[b]];
+            if (other.left <= box.right && box.left <= other.right) {
+                int root_a = group_root(m_move_work, m_move_sweep[a]);
+                int root_b = group_root(m_move_work, m_move_sweep[b]);
+                m_move_work[std::max(root_a, root_b)].group = std::min(root_a, root_b);
+            }
+        }
+    }
+    // a group's tile is gathered at its root, -2 until a member has been looked at
+    for (int m : m_move_sweep) {
+        m_move_work[m].tile = -2;
+    }
+    for (int m : m_move_sweep) {
+        const MoveWork& work = m_move_work[m];
+        int tile = tile_of_row(work.top);
+        if (tile != tile_of_row(work.bottom)) {
+            tile = -1;
+        }
+        MoveWork& root = m_move_work[group_root(m_move_work, m)];
+        if (root.tile == -2) {
+            root.tile = tile;
+        } else if (root.tile != tile) {
+            root.tile = -1;
+        }
+    }
+    for (std::vector<int>& jobs : m_tile_jobs) {
+        jobs.clear();
+    }
+    m_edge_jobs.clear();
+    for (int m = 0; m < count; m++) {
+        if (m_move_work[m].reach < 0) {
+            continue;
+        }
+        int tile = m_move_work[group_root(m_move_work, m)].tile;
+        if (tile >= 0) {
+            m_tile_jobs[tile].push_back(m);
+        } else {
+            m_edge_jobs.push_back(m);
+        }
+    }
+}
+
+void Arena::plan_tiles() {
+    // a simultaneous round on more than one thread resolves its moves and hits on tiles, bands of whole rows
+    // every band starts on a fresh 64 cell block of the bit board, so no two tiles ever write the same word.
+    // unless set_tile_rows asked for a size, there are about TILES_PER_THREAD bands per thread, none under
+    // MIN_TILE_ROWS rows so that most moves stay inside their own
+    m_tile_rows = m_height;
+    m_tile_count = 1;
+    if (!m_simultaneous || !m_decision_pool || m_decision_pool->size() <= 1 || m_height <= 0 || m_width <= 0) {
+        return;
+    }
+    int align = 64 / std::gcd(m_width, 64);
+    int rows = m_wanted_tile_rows;
+    if (rows <= 0) {
+        int tiles = m_decision_pool->size() * TILES_PER_THREAD;
+        rows = std::max(MIN_TILE_ROWS, (m_height + tiles - 1) / tiles);
+    }
+    rows = (rows + align - 1) / align * align;
+    m_tile_rows = rows;
+    m_tile_count = (m_height + rows - 1) / rows;
+    m_tile_jobs.resize(m_tile_count);
+}
+
+int Arena::tile_of_row(int row) {
+    return row / m_tile_rows;
+}
+
+MatchResult Arena::play_match() {
+    // plays a whole match from an empty board
+    start_match();
+    while (play_round()) {
+    }
+    return finish_match();
+}
+
+void Arena::start_match() {
+    // start the log before anything goes on the board so it sees every cell
+    if (!m_log_path.empty()) {
+        open_log();
+    }
     // place obstacles
-    place_obstacles(5, 1, 9);   // mounds, pits, flames
+    place_obstacles(m_mounds, m_pits, m_flames);
     // place robots
     place_robots();
-    bool cond = true;
-    int round = 1;
-    while (cond) {
-        // per round:
-        // display round number [in loop]
-        std::cout << "         =========== starting round " << round << " ===========";
-        // display board [board func]
+    m_damage_dealt.assign(m_robots_list.size(), 0);
+    m_damage_taken.assign(m_robots_list.size(), 0);
+    m_latencies.assign(m_robots_list.size(), std::vector<int64_t>());
+    m_overruns.assign(m_robots_list.size(), 0);
+    m_profiler.start(m_robots_list.size());
+    m_result.winner = -1;
+    m_result.seed = m_seed;
+    m_round = 1;
+    if (m_simultaneous && !m_decision_pool) {
+        m_decision_pool = std::make_unique<ThreadPool>(m_decision_threads);
+    }
+    plan_tiles();
+    // the turn log is written by its own thread while the match is watched
+    m_console.set_level(m_headless ? LOG_QUIET : m_verbosity);
+    if (!m_headless) {
+        std::vector<std::string> names;
+        std::vector<char> characters;
+        for (size_t i = 0; i < m_robots_list.size(); i++) {
+            names.push_back(m_robots_list[i]->m_name);
+            characters.push_back(m_robots_list[i]->m_character);
+        }
+        m_console.set_robots(names, characters);
+        m_console.set_board(m_height, m_width, isatty(STDOUT_FILENO));
+        m_console.start();
+    }
+}
+
+bool Arena::play_round() {
+    // plays round m_round and moves on to the next
+    // returns false once the match is over, leaving m_round on the last round played
+    // per round:
+    m_log.write(EVENT_ROUND, -1, 0, m_round);
+    // display round number [in loop]
+    m_console.push(CONSOLE_ROUND, -1, 0, m_round);
+    // display board [board func]
+    if (m_console.enabled(CONSOLE_BOARD)) {
         display_board();
+    }
 
-        // per robot:
+    // per robot:
+    if (m_simultaneous) {
+        if (!play_simultaneous_round()) {
+            return false;
+        }
+    } else {
         for (size_t i = 0; i < m_robots_list.size(); i++) {
-            std::cout << m_robots_list[i]->m_name << " " << m_robots_list[i]->m_character;
-            int row;
-            int col;
-            m_robots_list[i]->get_current_location(row, col);
-            std::cout << " (" << row << "," << col << ")";
-            // check for winner [board func]
-            if (is_winner()) {
-                return 0;
+            if (!play_turn(i)) {
+                return false;
             }
-            // check if alive [in loop]
-            if (m_robots_list[i]->get_health() <= 0) {
-                // if dead display so and next robot [in loop]
-                std::cout << " - is out" << std::endl << std::endl;
-                continue;
+        }
+    }
+    // per round:
+    // stop at the round limit, with a winner if the last round settled it
+    if (m_max_rounds > 0 && m_round >= m_max_rounds) {
+        if (!is_winner()) {
+            m_console.push(CONSOLE_OUT_OF_ROUNDS, -1, 0, m_round);
+        }
+        return false;
+    }
+    // sleep for live replay [in loop]
+    if (!m_headless) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    // incriment round [in loop]
+    m_round++;
+    return true;
+}
+
+bool Arena::play_turn(int i) {
+    // one robot's turn: radar, then a shot or a move
+    // returns false if the match was already won before the robot got to go
+    int row = m_robot_table.row(i);
+    int col = m_robot_table.col(i);
+    m_console.push(CONSOLE_TURN, i, 0, row, col);
+    // check for winner [board func]
+    if (is_winner()) {
+        return false;
+    }
+    // check if alive [in loop]
+    if (!m_robot_table.alive(i)) {
+        // if dead display so and next robot [in loop]
+        m_console.push(CONSOLE_OUT, i);
+        return true;
+    }
+    m_console.push(CONSOLE_STATUS, i, 0, m_robot_table.health(i), m_robot_table.armor(i));
+    // every callback is timed, and the turn as a whole is held to the budget
+    // a robot that goes over loses whatever it was about to do this turn
+    int64_t turn_ns = 0;
+    // call get radar dir [robot func]
+    int dir;
+    std::chrono::steady_clock::time_point radar_start = std::chrono::steady_clock::now();
+    m_robots_list[i]->get_radar_direction(dir);
+    bool on_time = time_callback(i, radar_start, turn_ns);
+    if (on_time) {
+        // scan using direction and robot pos [arena func]
+        robot_radar(i, dir, m_radar_results);
+        const std::vector<RadarObj>& radar_results = m_radar_results;
+        m_log.write(EVENT_RADAR, i, dir, row, col, radar_results.size());
+        m_console.push(CONSOLE_RADAR, i, 0, radar_results.size());
+        if (m_console.enabled(CONSOLE_RADAR_OBJECT)) {
+            for (size_t r = 0; r < radar_results.size(); r++) {
+                m_console.push(CONSOLE_RADAR_OBJECT, i, radar_results[r].m_type, radar_results[r].m_row, radar_results[r].m_col, r, radar_results.size());
             }
-            std::cout << " Health: " << m_robots_list[i]->get_health() << " Armor: " << m_robots_list[i]->get_armor() << std::endl;
-            // call get radar dir [robot func]
-            int dir;
-            m_robots_list[i]->get_radar_direction(dir);
-            // scan using direction and robot pos [arena func]
-            std::vector<RadarObj> radar_results = scan_radar(dir, row, col);
-            std::cout << "\tradar scan returned ";
-            if (!radar_results.size()) {
-                std::cout << "nothing" << std::endl;
-            } else {
-                std::string spacer = "";
-                for (size_t i = 0; i < radar_results.size(); i++) {
-                    std::cout << spacer;
-                    std::cout << radar_results[i].m_type << " at (" << radar_results[i].m_row << "," << radar_results[i].m_col << ")";
-                    spacer = ", and ";
+        }
+        // call process radar [robot func]
+        std::chrono::steady_clock::time_point call_start = std::chrono::steady_clock::now();
+        m_robots_list[i]->process_radar_results(radar_results);
+        on_time = time_callback(i, call_start, turn_ns);
+    }
+    // call get shot [robot func]
+    int start_row = row;
+    int start_col = col;
+    bool shooting = false;
+    if (on_time) {
+        std::chrono::steady_clock::time_point call_start = std::chrono::steady_clock::now();
+        shooting = m_robots_list[i]->get_shot_location(row, col);
+        on_time = time_callback(i, call_start, turn_ns);
+    }
+    if (on_time && shooting) {
+        // if true handle shot and damage [arena funcs]
+        m_console.push(CONSOLE_FIRING, i, 0, m_robot_table.weapon(i), row, col);
+        m_log.write(EVENT_SHOT, i, m_robot_table.weapon(i), row, col);
+        handle_shot(i, m_robot_table.weapon(i), row, col, start_row, start_col);
+    } else if (on_time) {
+        // else call get move direction and handle movement [robot func and board func]
+        int dist;
+        std::chrono::steady_clock::time_point call_start = std::chrono::steady_clock::now();
+        m_robots_list[i]->get_move_direction(dir, dist);
+        on_time = time_callback(i, call_start, turn_ns);
+        m_console.push(CONSOLE_NOT_FIRING, i);
+        if (on_time) {
+            MoveOrder order {i, dir, dist, start_row, start_col, false};
+            move_robot(order);
+            m_console.push(CONSOLE_MOVING, i, 0, order.row, order.col);
+        }
+    }
+    if (!on_time) {
+        m_overruns[i]++;
+        m_console.push(CONSOLE_FORFEIT, i);
+    }
+    // a sandboxed robot whose worker crashed or hung is out of the match
+    if (m_sandboxes[i] && m_sandboxes[i]->crashed() && m_robot_table.alive(i)) {
+        m_console.push(CONSOLE_STOPPED, i);
+        knock_out(i);
+    }
+    return true;
+}
+
+bool Arena::play_simultaneous_round() {
+    // every live robot decides against the board as it stood when the round began, all at once on the pool
+    // the decisions are then played out in robot order: every shot lands together as one batch of damage,
+    // after that the robots still standing move, each one seeing the moves made before it
+    // returns false if the match was already won before the round started
+    if (is_winner()) {
+        return false;
+    }
+    int count = m_robot_table.size();
+    m_decisions.resize(count);
+    for (int i = 0; i < count; i++) {
+        TurnDecision& decision = m_decisions[i];
+        decision.acted = m_robot_table.alive(i);
+        decision.row = m_robot_table.row(i);
+        decision.col = m_robot_table.col(i);
+        decision.health = m_robot_table.health(i);
+        decision.armor = m_robot_table.armor(i);
+    }
+    m_decision_pool->parallel_for(count, [this](size_t i) {
+        decide(i);
+    });
+
+    // shots first. each robot already worked out who its shot hits while deciding
+    // the damage is rolled in robot order, the same order a single thread would roll it in, and resolved in one go
+    m_pending_damage.clear();
+    for (int i = 0; i < count; i++) {
+        TurnDecision& decision = m_decisions[i];
+        if (decision.scanned) {
+            m_log.write(EVENT_RADAR, i, decision.radar_dir, decision.row, decision.col, decision.radar.size());
+        }
+        if (decision.on_time && decision.shooting) {
+            WeaponType weapon = m_robot_table.weapon(i);
+            m_log.write(EVENT_SHOT, i, weapon, decision.aim_row, decision.aim_col);
+            if (decision.fired) {
+                if (weapon == grenade) {
+                    m_robot_table.use_grenade(i);
+                }
+                for (int target : decision.targets) {
+                    queue_damage(WEAPON_DAMAGE[weapon].low, WEAPON_DAMAGE[weapon].high, target, i);
+                }
+            }
+        }
+    }
+    resolve_damage();
+    // back in the order they were fired, so each shooter's hits sit together
+    std::sort(m_pending_damage.begin(), m_pending_damage.end(), [](const PendingDamage& a, const PendingDamage& b) {
+        return a.sequence < b.sequence;
+    });
+    m_shot_hits.swap(m_pending_damage);
+
+    // then the robots still standing move, as one batch in robot order
+    m_move_orders.clear();
+    for (int i = 0; i < count; i++) {
+        TurnDecision& decision = m_decisions[i];
+        decision.move_order = -1;
+        if (decision.acted && decision.on_time && !decision.shooting) {
+            decision.move_order = m_move_orders.size();
+            m_move_orders.push_back(MoveOrder {i, decision.move_dir, decision.move_dist, decision.row, decision.col, false});
+        }
+    }
+    move_robots(m_move_orders);
+
+    // then what every robot did, printed the way a turn always is
+    size_t next_hit = 0;
+    for (int i = 0; i < count; i++) {
+        TurnDecision& decision = m_decisions[i];
+        m_console.push(CONSOLE_TURN, i, 0, decision.row, decision.col);
+        if (!decision.acted) {
+            m_console.push(CONSOLE_OUT, i);
+            continue;
+        }
+        m_console.push(CONSOLE_STATUS, i, 0, decision.health, decision.armor);
+        if (decision.scanned) {
+            m_console.push(CONSOLE_RADAR, i, 0, decision.radar.size());
+            if (m_console.enabled(CONSOLE_RADAR_OBJECT)) {
+                for (size_t r = 0; r < decision.radar.size(); r++) {
+                    m_console.push(CONSOLE_RADAR_OBJECT, i, decision.radar[r].m_type, decision.radar[r].m_row, decision.radar[r].m_col, r, decision.radar.size());
                 }
-                std::cout << std::endl;
             }
-            // call process radar [robot func]
-            m_robots_list[i]->process_radar_results(radar_results);
-            // call get shot [robot func]
-            int start_row = row;
-            int start_col = col;
-            if (m_robots_list[i]->get_shot_location(row, col)) {
-                // if true handle shot and damage [arena funcs]
-                std::cout << "\tfiring " << m_robots_list[i]->get_weapon() << " at (" << row << "," << col << ")" << std::endl;
-                handle_shot(m_robots_list[i]->get_weapon(), row, col, start_row, start_col);
+        }
+        if (decision.on_time && decision.shooting) {
+            m_console.push(CONSOLE_FIRING, i, 0, m_robot_table.weapon(i), decision.aim_row, decision.aim_col);
+            if (decision.fired) {
+                report_shot(i, m_shot_hits, next_hit);
+            } else {
+                m_console.push(CONSOLE_NO_GRENADES, i);
+            }
+        } else if (decision.on_time) {
+            m_console.push(CONSOLE_NOT_FIRING, i);
+            const MoveOrder& order = m_move_orders[decision.move_order];
+            if (order.moved) {
+                m_console.push(CONSOLE_MOVING, i, 0, order.row, order.col);
+            } else {
+                m_console.push(CONSOLE_SHOT_DOWN, i);
+            }
+        }
+        if (!decision.on_time) {
+            m_overruns[i]++;
+            m_console.push(CONSOLE_FORFEIT, i);
+        }
+        if (m_sandboxes[i] && m_sandboxes[i]->crashed() && m_robot_table.alive(i)) {
+            m_console.push(CONSOLE_STOPPED, i);
+            knock_out(i);
+        }
+    }
+    return true;
+}
+
+void Arena::decide(int i) {
+    // runs robot i's callbacks for a simultaneous round, timed like a turn, and keeps what it chose
+    // runs on the decision pool next to the other robots, so it only touches robot i's own state
+    // and reads the board, which nothing changes until every robot has decided
+    // a robot that shoots works out who its shot hits here too, so the targeting runs in parallel as well
+    TurnDecision& decision = m_decisions[i];
+    decision.scanned = false;
+    decision.on_time = true;
+    decision.shooting = false;
+    decision.fired = false;
+    decision.turn_ns = 0;
+    decision.radar.clear();
+    decision.targets.clear();
+    if (!decision.acted) {
+        return;
+    }
+    std::chrono::steady_clock::time_point call_start = std::chrono::steady_clock::now();
+    m_robots_list[i]->get_radar_direction(decision.radar_dir);
+    decision.on_time = time_callback(i, call_start, decision.turn_ns);
+    if (decision.on_time) {
+        robot_radar(i, decision.radar_dir, decision.radar);
+        decision.scanned = true;
+        call_start = std::chrono::steady_clock::now();
+        m_robots_list[i]->process_radar_results(decision.radar);
+        decision.on_time = time_callback(i, call_start, decision.turn_ns);
+    }
+    decision.aim_row = decision.row;
+    decision.aim_col = decision.col;
+    if (decision.on_time) {
+        call_start = std::chrono::steady_clock::now();
+        decision.shooting = m_robots_list[i]->get_shot_location(decision.aim_row, decision.aim_col);
+        decision.on_time = time_callback(i, call_start, decision.turn_ns);
+    }
+    if (decision.on_time && decision.shooting) {
+        WeaponType weapon = m_robot_table.weapon(i);
+        decision.fired = weapon != grenade || m_robot_table.grenades(i) > 0;
+        if (decision.fired) {
+            ScopedTimer timer(m_profiler, PHASE_SHOTS, i);
+            shot_targets(weapon, decision.aim_row, decision.aim_col, decision.row, decision.col, decision.shot_cells, decision.targets);
+        }
+    }
+    if (decision.on_time && !decision.shooting) {
+        call_start = std::chrono::steady_clock::now();
+        m_robots_list[i]->get_move_direction(decision.move_dir, decision.move_dist);
+        decision.on_time = time_callback(i, call_start, decision.turn_ns);
+    }
+}
+
+// the robots' names in the order they were loaded, for the reports that go by index
+static std::vector<std::string> result_names(const MatchResult& result) {
+    std::vector<std::string> names;
+    for (const RobotResult& robot : result.robots) {
+        names.push_back(robot.name);
+    }
+    return names;
+}
+
+MatchResult Arena::finish_match() {
+    // fill in the result from the per robot totals
+    m_result.rounds = m_round;
+    m_log.write(EVENT_END, -1, 0, m_result.winner, m_round);
+    m_log.close();
+    m_result.winner_name = m_result.winner >= 0 ? m_robots_list[m_result.winner]->m_name : "";
+    m_result.robots.clear();
+    for (size_t i = 0; i < m_robots_list.size(); i++) {
+        RobotResult robot;
+        robot.name = m_robots_list[i]->m_name;
+        robot.damage_dealt = m_damage_dealt[i];
+        robot.damage_taken = m_damage_taken[i];
+        robot.alive = m_robot_table.alive(i);
+        // percentiles by nearest rank, nth_element is enough since only three are needed
+        std::vector<int64_t>& latencies = m_latencies[i];
+        robot.callbacks = latencies.size();
+        robot.latency_p50_ns = 0;
+        robot.latency_p99_ns = 0;
+        robot.latency_max_ns = 0;
+        if (!latencies.empty()) {
+            size_t p50 = (latencies.size() - 1) * 50 / 100;
+            size_t p99 = (latencies.size() - 1) * 99 / 100;
+            std::nth_element(latencies.begin(), latencies.begin() + p50, latencies.end());
+            robot.latency_p50_ns = latencies[p50];
+            std::nth_element(latencies.begin() + p50, latencies.begin() + p99, latencies.end());
+            robot.latency_p99_ns = latencies[p99];
+            robot.latency_max_ns = *std::max_element(latencies.begin() + p99, latencies.end());
+        }
+        robot.overruns = m_overruns[i];
+        m_result.robots.push_back(robot);
+    }
+    if (m_profiler.enabled()) {
+        m_profiler.finish();
+        if (!m_profile_json.empty()) {
+            std::ofstream json(m_profile_json);
+            if (!json) {
+                std::cerr << "Can't write profile to " << m_profile_json << std::endl;
             } else {
-                // else call get move direction and handle movement [robot func and board func]
-                int dist;
-                m_robots_list[i]->get_move_direction(dir, dist);
-                std::cout << "\tnot firing" << std::endl;
-                move_robot(start_row, start_col, dir, dist);
+                m_profiler.write_json(json, result_names(m_result));
             }
         }
+    }
+    if (!m_headless) {
+        m_console.stop();
+        if (m_verbosity > LOG_QUIET) {
+            print_latencies();
+        }
+        if (m_profiler.enabled()) {
+            print_profile();
+        }
+    }
+    return m_result;
+}
 
-        // per round:
-        // sleep for live replay [in loop]
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        // incriment round [in loop]
-        round++;
+void Arena::take_snapshot(ArenaSnapshot& snapshot) {
+    // fills snapshot in place so taking one over and over reuses its memory
+    // meant to be taken between rounds, after play_round has returned true
+    snapshot.round = m_round;
+    snapshot.live_robots = m_live_robots;
+    snapshot.seed = m_seed;
+    snapshot.rng = m_rng;
+    snapshot.board = m_board;
+    snapshot.robots.resize(m_robots_list.size());
+    for (int i = 0; i < m_robot_table.size(); i++) {
+        RobotSnapshot& state = snapshot.robots[i];
+        state.row = m_robot_table.row(i);
+        state.col = m_robot_table.col(i);
+        state.health = m_robot_table.health(i);
+        state.armor = m_robot_table.armor(i);
+        state.move = m_robot_table.move(i);
+        state.grenades = m_robot_table.grenades(i);
+    }
+    snapshot.damage_dealt = m_damage_dealt;
+    snapshot.damage_taken = m_damage_taken;
+}
+
+bool Arena::restore_snapshot(const ArenaSnapshot& snapshot) {
+    // puts the board, dice and robots back the way they were when the snapshot was taken
+    // the occupancy and board indexes are rebuilt from that rather than stored
+    // a log can't follow the match back in time, so it ends here
+    // call set_seed afterwards to send the match down a different branch
+    if (snapshot.robots.size() != m_robots_list.size() || snapshot.board.size() != m_height*m_width) {
+        std::cerr << "Snapshot is from a different arena" << std::endl;
+        return false;
     }
+    m_log.close();
+    m_round = snapshot.round;
+    m_live_robots = snapshot.live_robots;
+    m_seed = snapshot.seed;
+    m_rng = snapshot.rng;
+    m_board = snapshot.board;
+    m_damage_dealt = snapshot.damage_dealt;
+    m_damage_taken = snapshot.damage_taken;
+    m_cell_robot.clear();
+    // timings start over with each branch
+    m_latencies.assign(m_robots_list.size(), std::vector<int64_t>());
+    m_overruns.assign(m_robots_list.size(), 0);
+    bool restored = true;
+    for (size_t i = 0; i < m_robots_list.size(); i++) {
+        restored = restore_robot(i, snapshot.robots[i]) && restored;
+        const RobotSnapshot& state = snapshot.robots[i];
+        if (pos_in_bounds(state.row, state.col)) {
+            m_cell_robot[pos_to_index(state.row, state.col)] = i;
+        }
+    }
+    m_board_index.rebuild(m_board);
+    m_result.winner = -1;
+    m_result.seed = m_seed;
+    return restored;
+}
+
+bool Arena::restore_robot(int robot, const RobotSnapshot& state) {
+    // RobotBase only lets health, armor, movement and grenades go down
+    // so a robot that has lost less than the snapshot just loses the difference,
+    // and one that has lost more is swapped for a fresh one from its factory first.
+    // a fresh robot keeps its place and stats but not whatever its own code had remembered
+    RobotBase* current = m_robots_list[robot];
+    bool reachable = current->get_health() >= state.health && current->get_armor() >= state.armor
+                  && (current->get_move_speed() > 0 || state.move == 0) && current->get_grenades() >= state.grenades;
+    if (!reachable) {
+        if (!m_robot_factories[robot]) {
+            std::cerr << "Can't rewind " << current->m_name << ", the arena doesn't know how to make another" << std::endl;
+            return false;
+        }
+        RobotBase* fresh;
+        if (m_sandboxed) {
+            fresh = SandboxedRobot::spawn(m_robot_factories[robot], m_sandbox_deadline_ms);
+        } else {
+            fresh = m_robot_factories[robot]();
+        }
+        if (!fresh) {
+            std::cerr << "Failed to create a fresh " << current->m_name << " to rewind to" << std::endl;
+            return false;
+        }
+        fresh->m_name = current->m_name;
+        fresh->m_character = current->m_character;
+        fresh->set_boundaries(m_height, m_width);
+        delete current;
+        current = fresh;
+        m_robots_list[robot] = fresh;
+        m_sandboxes[robot] = dynamic_cast<SandboxedRobot*>(fresh);
+    }
+    current->move_to(state.row, state.col);
+    current->take_damage(current->get_health() - state.health);
+    current->reduce_armor(current->get_armor() - state.armor);
+    if (state.move == 0) {
+        current->disable_movement();
+    }
+    while (current->get_grenades() > state.grenades) {
+        current->decrement_grenades();
+    }
+    m_robot_table.reload(robot, current);
+    return true;
+}
+
+void Arena::print_latencies() {
+    // one line per robot from the finished match result, times in microseconds
+    std::cout << std::endl << std::left << std::setw(20) << "Robot" << std::right
+              << std::setw(10) << "Calls" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "max us" << std::setw(10) << "Overruns" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < m_result.robots.size(); i++) {
+        const RobotResult& robot = m_result.robots[i];
+        std::cout << std::left << std::setw(20) << robot.name << std::right
+                  << std::setw(10) << robot.callbacks
+                  << std::setw(10) << robot.latency_p50_ns / 1000.0
+                  << std::setw(10) << robot.latency_p99_ns / 1000.0
+                  << std::setw(10) << robot.latency_max_ns / 1000.0
+                  << std::setw(10) << robot.overruns << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+void Arena::print_profile() {
+    // where the finished match spent its time and what it did, then the same per robot
+    m_profiler.print_report(std::cout, result_names(m_result));
+}
+
+const MatchResult& Arena::get_result() {
+    return m_result;
+}
+
+int Arena::game_loop() {
+    // on startup
+    // load robots
+    load_robots();
+    play_match();
     return 0;
 }
@@ -1,33 +1,268 @@
 #pragma once
 
 #include <vector>
+#include <string>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 
 #include "RobotBase.h"
+#include "Rng.h"
+#include "BoardIndex.h"
+#include "BitBoard.h"
+#include "ArenaConfig.h"
+#include "RobotLoader.h"
+#include "RobotSandbox.h"
+#include "RobotTable.h"
+#include "ThreadPool.h"
+#include "MatchLog.h"
+#include "ConsoleLog.h"
+#include "Profiler.h"
+
+// characters handed out to robots for the board display, in load order
+const std::string ROBOT_CHARACTERS = "@#$%&!*+=~^?";
+
+// a simultaneous round on more than one thread is resolved on bands of rows, about this many per thread,
+// each at least MIN_TILE_ROWS tall
+const int TILES_PER_THREAD = 4;
+const int MIN_TILE_ROWS = 16;
+
+// how one robot did over a match
+struct RobotResult {
+    std::string name;
+    int damage_dealt;
+    int damage_taken;
+    bool alive;
+    int callbacks;          // robot callbacks timed over the match
+    int64_t latency_p50_ns; // and how long they took
+    int64_t latency_p99_ns;
+    int64_t latency_max_ns;
+    int overruns;           // turns forfeited for going over the turn budget
+};
+
+// what play_match hands back once the match is over
+struct MatchResult {
+    int winner;     // index into the robot list, -1 if no robot won
+    std::string winner_name;
+    int rounds;
+    uint64_t seed;  // replaying with this seed gives the same board and damage rolls
+    std::vector<RobotResult> robots;
+};
+
+// a hit waiting to be applied. resolving it fills in what got through, -1 if it was dropped,
+// and the health and armor it left the robot on
+struct PendingDamage {
+    int robot;
+    int attacker;   // -1 for the arena itself
+    int roll;
+    int damage;
+    int sequence;   // order it was queued in, hits on one robot are applied in this order
+    int health;
+    int armor;
+};
+
+// one robot's move. row and col say where it ended up once the move is played
+struct MoveOrder {
+    int robot;
+    int dir;        // index into directions[]
+    int distance;   // cut down to the robot's speed
+    int row;
+    int col;
+    bool moved;     // false if the robot was out before its turn to move came
+};
+
+// the arena's side of one move in a batch. before anyone moves it is given the cells it could
+// reach and the box they lie in; the walk then fills in what it did that can only be published
+// once every tile is done. its flame hits sit in m_move_hits from first_hit on
+struct MoveWork {
+    int reach;      // cells it could cross, -1 if its robot is out and it won't move
+    int top;        // the box those cells lie in, the robot's own cell included
+    int bottom;
+    int left;
+    int right;
+    int group;      // union-find parent, moves whose boxes overlap end up in one group
+    int tile;       // at a group's root, the tile the group is walked on, -1 if it crosses a tile edge
+    int first_hit;
+    int hits;
+    int start;      // the cell it left
+    bool entered_empty;     // the cell it ended on held nothing before, it wasn't a pit
+};
+
+// what one robot chose to do in a simultaneous round, made against the board as it stood when the round began
+struct TurnDecision {
+    bool acted;     // alive when the round began
+    int row;
+    int col;
+    int health;
+    int armor;
+    int radar_dir;
+    std::vector<RadarObj> radar;    // reused round after round
+    bool scanned;
+    bool on_time;
+    bool shooting;
+    bool fired;     // a grenade launcher with no grenades left doesn't
+    std::vector<int> shot_cells;    // the cells its shot covers, reused round after round
+    std::vector<int> targets;       // the robots standing in them
+    int move_order;     // its entry in the round's move batch, -1 if it isn't moving
+    int aim_row;
+    int aim_col;
+    int move_dir;
+    int move_dist;
+    int64_t turn_ns;
+};
+
+// one robot's state in a snapshot, everything the arena can change through RobotBase
+struct RobotSnapshot {
+    int row;
+    int col;
+    int health;
+    int armor;
+    int move;
+    int grenades;
+};
+
+// everything needed to carry a match on from the start of a round. taking one
+// copies the bit board and a few numbers per robot, restoring one puts them back
+struct ArenaSnapshot {
+    int round;      // the next round to play
+    int live_robots;
+    uint64_t seed;
+    Rng rng;
+    BitBoard board;
+    std::vector<RobotSnapshot> robots;
+    std::vector<int> damage_dealt;
+    std::vector<int> damage_taken;
+};
 
 class Arena {
 private:
     std::vector<RobotBase*> m_robots_list;
+    RobotTable m_robot_table;   // the arena's copy of every robot's state, kept in step with m_robots_list
     std::vector<void*> m_robots_handles;
+    std::vector<SandboxedRobot*> m_sandboxes;   // per robot, nullptr for robots running in this process
+    std::vector<RobotFactory> m_robot_factories;    // per robot, what made it, nullptr if it was handed in ready made
     int m_height;
     int m_width;
-    std::vector<char> m_board;
+    BitBoard m_board;               // a bit plane per cell type, display_board turns it back into characters
+    BoardIndex m_board_index;       // where the non-empty cells are along every column and diagonal
+    bool m_board_index_stale;       // set while placing, set_cell skips the index until it is rebuilt
+    std::unordered_map<int, int> m_cell_robot;  // robot index by cell, only for the cells robots are on. dead robots keep their cell
+    int m_live_robots;              // robots on the board with health left
+    int m_free_left;                // cells never handed out by draw_free_cell
+    std::unordered_map<int, int> m_free_swaps;  // the slots of that shuffle that no longer hold their own cell
+    std::vector<RadarObj> m_radar_results;  // scan_radar fills this in place, valid until the next scan
+    std::vector<int> m_shot_cells;          // handle_shot fills this in place with the cells a shot covers
+    std::vector<PendingDamage> m_pending_damage;    // hits from the current action, waiting for resolve_damage
+    std::vector<PendingDamage> m_shot_hits;         // a simultaneous round's resolved shots, in the order they were fired
+    std::vector<TurnDecision> m_decisions;          // per robot, filled in by decide
+    std::vector<MoveOrder> m_move_orders;           // a simultaneous round's moves
+    std::vector<MoveWork> m_move_work;              // per move in the batch being played
+    std::vector<PendingDamage> m_move_hits;         // the flames those moves cross, a slot per cell each could reach
+    std::vector<int> m_move_sweep;                  // the batch's moves by top row, for finding the overlapping ones
+    std::vector<int> m_hit_runs;                    // where each robot's hits start in a sorted damage batch
+    int m_tile_rows;            // rows in each tile a simultaneous round is resolved on
+    int m_tile_count;           // 1 resolves everything on the arena's own thread
+    int m_wanted_tile_rows;     // set_tile_rows, 0 picks a size from the board and the threads
+    std::vector<std::vector<int>> m_tile_jobs;      // per tile, the moves or hit runs it resolves, in order
+    std::vector<int> m_edge_jobs;                   // moves whose group reaches over a tile edge, walked after the tiles
+    bool m_headless;    // no sleeping and no printing, just play as fast as possible
+    int m_max_rounds;   // 0 means play until there is a winner
+    int m_mounds;
+    int m_pits;
+    int m_flames;
+    std::vector<int> m_damage_dealt;
+    std::vector<int> m_damage_taken;
+    std::vector<std::vector<int64_t>> m_latencies;  // per robot, how long each callback took in ns
+    std::vector<int> m_overruns;
+    int m_turn_budget_us;   // 0 means a turn can take as long as it likes
+    std::string m_log_path; // where play_match writes its event log, empty for no log
+    MatchLogWriter m_log;
+    ConsoleLog m_console;   // the live turn log and board, quiet when headless
+    int m_verbosity;        // LogLevel for matches that are watched
+    MatchResult m_result;
+    int m_round;    // the round being played
+    uint64_t m_seed;
+    Rng m_rng;      // all placement and damage rolls come from here
+    bool m_sandboxed;           // run each robot in its own worker process
+    int m_sandbox_deadline_ms;  // how long a sandboxed robot gets per call
+    bool m_simultaneous;        // every robot decides at once, then the decisions are played out
+    int m_decision_threads;     // threads the robots decide on, 0 means one per core
+    std::unique_ptr<ThreadPool> m_decision_pool;
+    std::vector<int> m_shot_targets;                // the same for a shot on its own
+    Profiler m_profiler;        // per phase timings and counts, off unless profiling is asked for
+    std::string m_profile_json; // where finish_match writes the profile as JSON, empty for none
 public:
     Arena();    // basic size and no obstacles
     Arena(int height, int width); // takes width, height, num obstacles
+    Arena(int height, int width, bool headless);
+    Arena(const ArenaConfig& config);
     virtual ~Arena();
+    void set_headless(bool headless);
+    void set_max_rounds(int max_rounds);
+    void set_obstacles(int mounds, int pits, int flames);
+    void set_seed(uint64_t seed);
+    uint64_t get_seed();
+    void set_sandboxed(bool sandboxed, int deadline_ms);
+    void set_turn_budget(int budget_us);
+    void set_simultaneous(bool simultaneous, int threads);
+    void set_tile_rows(int rows);
+    void set_profiling(bool profile, const std::string& json_path);
+    void set_verbosity(int level);
+    void set_log_path(const std::string& path);
+    void open_log();
     void load_robots();
+    void add_robot(RobotBase* robot, const std::string& name);
+    bool add_robot_from(const RobotLibrary& library);
     int random_index();
+    int draw_free_cell();
     void place_obstacles(int mounds, int pits, int flames);
     void index_to_pos(int index, int& row, int& col);
     void place_robots();
     int position_to_robot(int row, int col);
+    int cell_robot(int index);
+    char cell_at(int row, int col);
     void display_board();
     bool is_winner();
     int pos_to_index(int row, int col);
+    void set_cell(int index, char type);
+    void publish_cell(int index, char type, bool was_empty);
     bool pos_in_bounds(int row, int col);
-    std::vector<RadarObj> scan_radar(int dir, int start_row, int start_col);
-    void handle_shot(WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col);
-    void do_damage(int low_damage, int high_damage, int robot);
-    void move_robot(int start_row, int start_col, int dir, int speed);
+    void clip_ray(int start, int step, int size, int& first, int& last);
+    const std::vector<RadarObj>& scan_radar(int dir, int start_row, int start_col);
+    int scan_radar(int dir, int start_row, int start_col, std::vector<RadarObj>& results);
+    void robot_radar(int robot, int dir, std::vector<RadarObj>& results);
+    void shot_targets(WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col, std::vector<int>& cells, std::vector<int>& targets);
+    bool queue_shot(int shooter, WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col);
+    void report_shot(int shooter, const std::vector<PendingDamage>& hits, size_t& next);
+    void handle_shot(int shooter, WeaponType weapon, int aim_row, int aim_col, int start_row, int start_col);
+    void queue_damage(int low_damage, int high_damage, int robot, int attacker);
+    void resolve_damage();
+    void resolve_hits(std::vector<PendingDamage>& hits, int first, int last);
+    void publish_hits(const std::vector<PendingDamage>& hits, int first, int last);
+    void knock_out(int robot);
+    void publish_death(int robot);
+    bool time_callback(int robot, std::chrono::steady_clock::time_point call_start, int64_t& turn_ns);
+    int move_reach(const MoveOrder& order, int& d_row, int& d_col);
+    void walk_move(MoveOrder& order, MoveWork& work, bool rolled);
+    void publish_move(const MoveOrder& order, const MoveWork& work);
+    void move_robot(MoveOrder& order);
+    void move_robots(std::vector<MoveOrder>& orders);
+    void plan_tiles();
+    int tile_of_row(int row);
+    void group_moves(const std::vector<MoveOrder>& orders);
+    MatchResult play_match();
+    void start_match();
+    bool play_round();
+    bool play_turn(int robot);
+    bool play_simultaneous_round();
+    void decide(int robot);
+    MatchResult finish_match();
+    void take_snapshot(ArenaSnapshot& snapshot);
+    bool restore_snapshot(const ArenaSnapshot& snapshot);
+    bool restore_robot(int robot, const RobotSnapshot& state);
+    void print_latencies();
+    void print_profile();
+    const MatchResult& get_result();
     int game_loop();
 };
\ No newline at end of file
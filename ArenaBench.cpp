@@ -0,0 +1,364 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Arena.h"
+#include "ArenaConfig.h"
+#include "RobotLoader.h"
+#include "Rng.h"
+#include "Profiler.h"
+
+// micro benchmarks for the arena's hot paths plus whole matches of the sample robots.
+// everything runs from fixed seeds so two runs do the same work, and each line reports
+// nanoseconds and heap allocations per operation. set up work (building boards, putting
+// them back between batches) is left out of both numbers.
+// ArenaBench [FILTER] runs only the benchmarks whose name contains FILTER.
+
+// seed for every board, aim and move the benchmarks use
+const uint64_t BENCH_SEED = 20240601;
+
+// matches played by the end to end benchmark
+const int BENCH_MATCHES = 200;
+const int BENCH_MATCH_ROUNDS = 1000;
+
+// a robot that never does anything, the benchmarks drive the arena directly
+class BenchRobot : public RobotBase {
+public:
+    BenchRobot(WeaponType weapon) : RobotBase(3, 2, weapon) {}
+    void get_radar_direction(int& radar_direction) override {
+        radar_direction = 0;
+    }
+    void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+        (void) radar_results;
+    }
+    bool get_shot_location(int& shot_row, int& shot_col) override {
+        (void) shot_row;
+        (void) shot_col;
+        return false;
+    }
+    void get_move_direction(int& move_direction, int& move_distance) override {
+        move_direction = 0;
+        move_distance = 0;
+    }
+};
+
+// the arena can only rewind a robot it knows how to make again, so the benchmarks hand it factories
+RobotBase* make_flamethrower_robot() {
+    return new BenchRobot(flamethrower);
+}
+
+RobotBase* make_railgun_robot() {
+    return new BenchRobot(railgun);
+}
+
+RobotBase* make_grenade_robot() {
+    return new BenchRobot(grenade);
+}
+
+RobotBase* make_hammer_robot() {
+    return new BenchRobot(hammer);
+}
+
+const RobotFactory BENCH_FACTORIES[4] = {
+    make_flamethrower_robot, make_railgun_robot, make_grenade_robot, make_hammer_robot
+};
+
+// one board to run benchmarks on: size by size, density percent of it under obstacles
+struct BenchBoard {
+    int size;
+    int density;
+};
+
+const BenchBoard BENCH_BOARDS[] = {
+    {10, 10}, {10, 40}, {100, 10}, {100, 40}, {1000, 10}, {1000, 40}
+};
+
+// operations per benchmark on a board, fewer on the bigger boards
+long long scaled_ops(int size, long long small_ops) {
+    return size <= 10 ? small_ops : size <= 100 ? small_ops / 4 : small_ops / 50;
+}
+
+class Bench {
+private:
+    std::string m_filter;
+    std::chrono::steady_clock::time_point m_start;
+    long long m_start_allocations;
+    int64_t m_elapsed_ns;
+    long long m_allocations;
+public:
+    Bench(const std::string& filter) : m_filter(filter), m_start_allocations(0), m_elapsed_ns(0), m_allocations(0) {}
+
+    bool wanted(const std::string& name) {
+        return m_filter.empty() || name.find(m_filter) != std::string::npos;
+    }
+
+    // a benchmark times one or more stretches of work between start and stop, then reports them together
+    void reset() {
+        m_elapsed_ns = 0;
+        m_allocations = 0;
+    }
+
+    void start() {
+        m_start_allocations = allocation_count();
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        m_elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+        m_allocations += allocation_count() - m_start_allocations;
+    }
+
+    void report(const std::string& name, long long ops) {
+        std::cout << std::left << std::setw(44) << name << std::right
+                  << std::setw(12) << ops
+                  << std::setw(14) << std::fixed << std::setprecision(1) << static_cast<double>(m_elapsed_ns) / ops
+                  << std::setw(12) << std::setprecision(2) << static_cast<double>(m_allocations) / ops << std::endl;
+    }
+};
+
+std::string board_name(const BenchBoard& board) {
+    return std::to_string(board.size) + "x" + std::to_string(board.size) + " " + std::to_string(board.density) + "%";
+}
+
+Arena* make_arena(const BenchBoard& board, WeaponType first_weapon) {
+    // a headless arena with its obstacles and robots already placed
+    // robot 0 carries first_weapon, a robot for every 20 cells after that
+    ArenaConfig config = default_config();
+    config.watch_live = false;
+    config.height = board.size;
+    config.width = board.size;
+    int cells = board.size * board.size;
+    config.mounds = cells * board.density / 200;
+    config.pits = cells * board.density / 1000;
+    config.flames = cells * board.density / 100 - config.mounds - config.pits;
+    config.has_seed = true;
+    config.seed = BENCH_SEED;
+    Arena* arena = new Arena(config);
+    int robots = std::max(2, std::min(cells / 20, 5000));
+    for (int i = 0; i < robots; i++) {
+        RobotLibrary library {"bench", nullptr, BENCH_FACTORIES[i == 0 ? first_weapon : railgun]};
+        arena->add_robot_from(library);
+    }
+    arena->start_match();
+    return arena;
+}
+
+// cells spread over the board to aim, scan and look from
+std::vector<std::pair<int, int>> random_cells(int size, int count) {
+    Rng rng(BENCH_SEED);
+    std::vector<std::pair<int, int>> cells(count);
+    for (int i = 0; i < count; i++) {
+        cells[i] = {rng.below(size), rng.below(size)};
+    }
+    return cells;
+}
+
+void bench_scan_radar(Bench& bench) {
+    // every direction from a spread of cells, on every board
+    for (const BenchBoard& board : BENCH_BOARDS) {
+        Arena* arena = make_arena(board, railgun);
+        std::vector<std::pair<int, int>> cells = random_cells(board.size, 1024);
+        for (int dir = 0; dir <= 8; dir++) {
+            std::string name = "scan_radar " + board_name(board) + " dir " + std::to_string(dir);
+            if (!bench.wanted(name)) {
+                continue;
+            }
+            long long ops = scaled_ops(board.size, 200000);
+            size_t found = 0;
+            bench.reset();
+            bench.start();
+            for (long long i = 0; i < ops; i++) {
+                const std::pair<int, int>& cell = cells[i & 1023];
+                found += arena->scan_radar(dir, cell.first, cell.second).size();
+            }
+            bench.stop();
+            bench.report(name, ops);
+            if (found == static_cast<size_t>(-1)) {
+                std::cout << found << std::endl;
+            }
+        }
+        delete arena;
+    }
+}
+
+void bench_handle_shot(Bench& bench) {
+    // robot 0 fires at a spread of cells, the board is put back every few shots
+    // so the shots keep finding robots to hit and grenades to throw
+    const char* weapon_names[] = {"flamethrower", "railgun", "grenade", "hammer"};
+    const int batch = 10;
+    for (const BenchBoard& board : BENCH_BOARDS) {
+        for (int weapon = flamethrower; weapon <= hammer; weapon++) {
+            std::string name = std::string("handle_shot ") + weapon_names[weapon] + " " + board_name(board);
+            if (!bench.wanted(name)) {
+                continue;
+            }
+            Arena* arena = make_arena(board, static_cast<WeaponType>(weapon));
+            ArenaSnapshot snapshot;
+            arena->take_snapshot(snapshot);
+            RobotSnapshot& shooter = snapshot.robots[0];
+            std::vector<std::pair<int, int>> cells = random_cells(board.size, 1024);
+            // putting a big board back costs far more than a shot, so those get fewer
+            long long ops = board.size <= 100 ? scaled_ops(board.size, 100000) : 200;
+            bench.reset();
+            for (long long i = 0; i < ops; i += batch) {
+                arena->restore_snapshot(snapshot);
+                bench.start();
+                for (int b = 0; b < batch; b++) {
+                    const std::pair<int, int>& aim = cells[(i + b) & 1023];
+                    arena->handle_shot(0, static_cast<WeaponType>(weapon), aim.first, aim.second, shooter.row, shooter.col);
+                }
+                bench.stop();
+            }
+            bench.report(name, ops);
+            delete arena;
+        }
+    }
+}
+
+void bench_move_robot(Bench& bench) {
+    // the robots take turns moving two cells, round the eight directions
+    // the board is put back every so often so they don't all end up stuck
+    const int batch = 1000;
+    for (const BenchBoard& board : BENCH_BOARDS) {
+        std::string name = "move_robot " + board_name(board);
+        if (!bench.wanted(name)) {
+            continue;
+        }
+        Arena* arena = make_arena(board, railgun);
+        ArenaSnapshot snapshot;
+        arena->take_snapshot(snapshot);
+        int robots = snapshot.robots.size();
+        long long ops = scaled_ops(board.size, 1000000) / batch * batch;
+        bench.reset();
+        for (long long i = 0; i < ops; i += batch) {
+            arena->restore_snapshot(snapshot);
+            bench.start();
+            for (int b = 0; b < batch; b++) {
+                long long n = i + b;
+                MoveOrder order {static_cast<int>(n % robots), static_cast<int>(n % 8) + 1, 2, 0, 0, false};
+                arena->move_robot(order);
+            }
+            bench.stop();
+        }
+        bench.report(name, ops);
+        delete arena;
+    }
+}
+
+void bench_lookups(Bench& bench) {
+    // position_to_robot over a spread of cells, is_winner with the board still full, display_board in full
+    for (const BenchBoard& board : BENCH_BOARDS) {
+        Arena* arena = make_arena(board, railgun);
+        std::vector<std::pair<int, int>> cells = random_cells(board.size, 1024);
+
+        std::string name = "position_to_robot " + board_name(board);
+        if (bench.wanted(name)) {
+            long long ops = 10000000;
+            long long sum = 0;
+            bench.reset();
+            bench.start();
+            for (long long i = 0; i < ops; i++) {
+                const std::pair<int, int>& cell = cells[i & 1023];
+                sum += arena->position_to_robot(cell.first, cell.second);
+            }
+            bench.stop();
+            bench.report(name, ops);
+            if (sum == -1) {
+                std::cout << sum << std::endl;
+            }
+        }
+
+        name = "is_winner " + board_name(board);
+        if (bench.wanted(name)) {
+            long long ops = 10000000;
+            long long wins = 0;
+            bench.reset();
+            bench.start();
+            for (long long i = 0; i < ops; i++) {
+                wins += arena->is_winner();
+            }
+            bench.stop();
+            bench.report(name, ops);
+            if (wins == -1) {
+                std::cout << wins << std::endl;
+            }
+        }
+
+        name = "display_board " + board_name(board);
+        if (bench.wanted(name)) {
+            // a headless arena keeps its console quiet and set_verbosity only reaches the console of
+            // one that is watched, so the arena is watched just long enough to turn the board on.
+            // with the formatter not running every frame is rendered on the spot by BoardRenderer,
+            // into /dev/null so what is timed is the drawing and not the terminal
+            arena->set_headless(false);
+            arena->set_verbosity(LOG_BOARD);
+            arena->set_headless(true);
+            std::cout.flush();
+            int saved_stdout = dup(STDOUT_FILENO);
+            int null_out = open("/dev/null", O_WRONLY);
+            dup2(null_out, STDOUT_FILENO);
+            long long ops = board.size <= 10 ? 100000 : board.size <= 100 ? 2000 : 20;
+            bench.reset();
+            bench.start();
+            for (long long i = 0; i < ops; i++) {
+                arena->display_board();
+            }
+            bench.stop();
+            std::cout.flush();
+            dup2(saved_stdout, STDOUT_FILENO);
+            close(null_out);
+            close(saved_stdout);
+            bench.report(name, ops);
+        }
+        delete arena;
+    }
+}
+
+void bench_matches(Bench& bench) {
+    // whole headless matches of the sample robots, one after another on this thread
+    std::string name = "match sample robots";
+    if (!bench.wanted(name)) {
+        return;
+    }
+    std::vector<RobotLibrary> libraries = load_robot_libraries("./");
+    if (libraries.size() < 2) {
+        std::cerr << "Need at least two robots for the match benchmark, found " << libraries.size() << std::endl;
+        close_robot_libraries(libraries);
+        return;
+    }
+    ArenaConfig config = default_config();
+    config.watch_live = false;
+    config.max_rounds = BENCH_MATCH_ROUNDS;
+    bench.reset();
+    bench.start();
+    for (int match = 0; match < BENCH_MATCHES; match++) {
+        Arena arena(config);
+        arena.set_seed(BENCH_SEED + match);
+        for (size_t i = 0; i < libraries.size(); i++) {
+            arena.add_robot_from(libraries[i]);
+        }
+        arena.play_match();
+    }
+    bench.stop();
+    bench.report(name, BENCH_MATCHES);
+    close_robot_libraries(libraries);
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    Bench bench(filter);
+    count_allocations(true);
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right
+              << std::setw(12) << "ops" << std::setw(14) << "ns/op" << std::setw(12) << "allocs/op" << std::endl;
+    bench_scan_radar(bench);
+    bench_handle_shot(bench);
+    bench_move_robot(bench);
+    bench_lookups(bench);
+    bench_matches(bench);
+    count_allocations(false);
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+
+#include "ArenaConfig.h"
+#include "RobotSandbox.h"
+
+ArenaConfig default_config() {
+    ArenaConfig config;
+    config.height = 10;
+    config.width = 10;
+    config.mounds = 5;
+    config.pits = 1;
+    config.flames = 9;
+    config.max_rounds = 0;
+    config.has_seed = false;
+    config.seed = 0;
+    config.watch_live = true;
+    config.sandbox = false;
+    config.sandbox_deadline_ms = SANDBOX_DEADLINE_MS;
+    config.turn_budget_us = 0;
+    config.simultaneous = false;
+    config.decision_threads = 0;
+    config.log_file = "";
+    config.verbosity = 3;
+    config.profile = false;
+    config.profile_json = "";
+    return config;
+}
+
+static std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+static bool parse_int(const std::string& value, long long& number) {
+    // the whole value has to be a number
+    // and small enough to fit in a long long
+    char* end;
+    errno = 0;
+    number = std::strtoll(value.c_str(), &end, 10);
+    return !value.empty() && *end == '\0' && errno != ERANGE;
+}
+
+bool parse_seed(const std::string& value, uint64_t& seed) {
+    // strtoull would quietly wrap a minus sign around, so only digits are let through
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    errno = 0;
+    seed = std::strtoull(value.c_str(), nullptr, 10);
+    return errno != ERANGE;
+}
+
+bool load_config(const std::string& path, ArenaConfig& config) {
+    // reads each line, strips comments and spaces, then sets the matching field
+    // checks the finished config against what the arena can actually play
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Could not open config file " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line = line.substr(0, comment);
+        }
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cerr << path << ":" << line_number << ": expected key = value" << std::endl;
+            continue;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+
+        long long number = 0;
+        if (key == "log_file") {
+            config.log_file = value;
+            continue;
+        }
+        if (key == "profile_json") {
+            config.profile_json = value;
+            continue;
+        }
+        if (key == "watch_live" || key == "sandbox" || key == "simultaneous" || key == "profile") {
+            bool& flag = key == "watch_live" ? config.watch_live : key == "sandbox" ? config.sandbox
+                       : key == "simultaneous" ? config.simultaneous : config.profile;
+            if (value == "true" || value == "yes" || value == "1") {
+                flag = true;
+            } else if (value == "false" || value == "no" || value == "0") {
+                flag = false;
+            } else {
+                std::cerr << path << ":" << line_number << ": " << key << " should be true or false" << std::endl;
+            }
+            continue;
+        }
+        if (key == "seed") {
+            if (!parse_seed(value, config.seed)) {
+                std::cerr << path << ":" << line_number << ": seed needs a whole number from 0 to " << UINT64_MAX << ", not " << value << std::endl;
+                continue;
+            }
+            config.has_seed = true;
+            continue;
+        }
+        if (!parse_int(value, number) || number < 0) {
+            std::cerr << path << ":" << line_number << ": " << key << " needs a whole number, not " << value << std::endl;
+            continue;
+        }
+        // every other setting goes into an int
+        if (number > INT_MAX) {
+            std::cerr << path << ":" << line_number << ": " << key << " can be at most " << INT_MAX << ", not " << value << std::endl;
+            continue;
+        }
+        if (key == "height") {
+            config.height = number;
+        } else if (key == "width") {
+            config.width = number;
+        } else if (key == "mounds") {
+            config.mounds = number;
+        } else if (key == "pits") {
+            config.pits = number;
+        } else if (key == "flames") {
+            config.flames = number;
+        } else if (key == "max_rounds") {
+            config.max_rounds = number;
+        } else if (key == "sandbox_deadline_ms") {
+            config.sandbox_deadline_ms = number;
+        } else if (key == "verbosity") {
+            config.verbosity = number;
+        } else if (key == "turn_budget_us") {
+            config.turn_budget_us = number;
+        } else if (key == "decision_threads") {
+            config.decision_threads = number;
+        } else {
+            std::cerr << path << ":" << line_number << ": unknown key " << key << std::endl;
+        }
+    }
+
+    if (config.height < MIN_ARENA_SIZE || config.width < MIN_ARENA_SIZE) {
+        std::cerr << path << ": the arena must be at least " << MIN_ARENA_SIZE << "x" << MIN_ARENA_SIZE << std::endl;
+        return false;
+    }
+    if ((long long)config.height * config.width > MAX_ARENA_CELLS) {
+        std::cerr << path << ": the arena can have at most " << MAX_ARENA_CELLS << " cells, "
+                  << config.height << "x" << config.width << " is too many" << std::endl;
+        return false;
+    }
+    if ((long long)config.mounds + config.pits + config.flames >= (long long)config.height * config.width) {
+        std::cerr << path << ": too many obstacles to leave room for the robots" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <climits>
+
+// the smallest arena the spec allows
+const int MIN_ARENA_SIZE = 10;
+// the most cells an arena can have. cells are indexed with int, and a board frame holds two characters per cell
+const long long MAX_ARENA_CELLS = INT_MAX / 2;
+
+// everything about a match that can be changed without recompiling
+struct ArenaConfig {
+    int height;
+    int width;
+    int mounds;
+    int pits;
+    int flames;
+    int max_rounds;     // 0 means play until there is a winner
+    bool has_seed;      // without a seed every match gets a fresh one
+    uint64_t seed;
+    bool watch_live;    // false runs headless
+    bool sandbox;       // run each robot in its own worker process
+    int sandbox_deadline_ms;    // how long a sandboxed robot gets to answer one call
+    int turn_budget_us; // how long a robot's whole turn may take before it loses its action, 0 for no limit
+    bool simultaneous;  // every robot decides against the same board each round, then the decisions are played out
+    int decision_threads;   // threads those decisions are made on, 0 means one per core
+    std::string log_file;   // binary event log of the match, empty for none
+    int verbosity;      // how much a watched match prints, a LogLevel from 0 (nothing) to 3 (radar too)
+    bool profile;       // time every phase of the match and report it at the end
+    std::string profile_json;   // where that report is also written as JSON, empty for nowhere. setting it turns profile on
+};
+
+// reads a seed, any whole number from 0 to 2^64 - 1, the same way for the config file and --seed
+bool parse_seed(const std::string& value, uint64_t& seed);
+
+// a 10x10 arena with 5 mounds, 1 pit and 9 flames, no round limit, watched live
+ArenaConfig default_config();
+
+// reads "key = value" lines into config, anything after a # is a comment.
+// keys are height, width, mounds, pits, flames, max_rounds, seed, watch_live,
+// sandbox, sandbox_deadline_ms, turn_budget_us, simultaneous, decision_threads, log_file, verbosity,
+// profile and profile_json.
+// unknown keys and bad values are reported and the rest of the file is still read.
+// returns false if the file can't be opened or holds a value the arena can't use.
+bool load_config(const std::string& path, ArenaConfig& config);
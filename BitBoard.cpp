@@ -0,0 +1,126 @@
+#include <bit>
+#include <cstddef>
+
+#include "BitBoard.h"
+
+// board characters for each plane, in CellPlane order
+static const char PLANE_CHARS[PLANE_COUNT] = {'R', 'X', 'M', 'P', 'F'};
+
+BitBoard::BitBoard() : m_cells(0) {}
+
+void BitBoard::reset(int cells) {
+    m_cells = cells;
+    m_words.assign(((cells + 63) / 64) * PLANE_COUNT, 0);
+}
+
+int BitBoard::size() const {
+    return m_cells;
+}
+
+CellPlane BitBoard::plane_of(char type) {
+    // PLANE_COUNT stands for an empty cell
+    switch (type) {
+        case 'R': return PLANE_ROBOT;
+        case 'X': return PLANE_DEAD;
+        case 'M': return PLANE_MOUND;
+        case 'P': return PLANE_PIT;
+        case 'F': return PLANE_FLAME;
+        default: return PLANE_COUNT;
+    }
+}
+
+uint64_t BitBoard::occupied_word(int block) const {
+    const uint64_t* words = &m_words[block*PLANE_COUNT];
+    return words[PLANE_ROBOT] | words[PLANE_DEAD] | words[PLANE_MOUND] | words[PLANE_PIT] | words[PLANE_FLAME];
+}
+
+char BitBoard::get(int index) const {
+    // empty is by far the most common answer, so check that with one OR first
+    int block = index >> 6;
+    uint64_t bit = 1ull << (index & 63);
+    if (!(occupied_word(block) & bit)) {
+        return '.';
+    }
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        if (m_words[block*PLANE_COUNT + p] & bit) {
+            return PLANE_CHARS[p];
+        }
+    }
+    return '.';
+}
+
+void BitBoard::set(int index, char type) {
+    // clear the cell in every plane, then set it in the one for type
+    int block = index >> 6;
+    uint64_t bit = 1ull << (index & 63);
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        m_words[block*PLANE_COUNT + p] &= ~bit;
+    }
+    CellPlane plane = plane_of(type);
+    if (plane != PLANE_COUNT) {
+        m_words[block*PLANE_COUNT + plane] |= bit;
+    }
+}
+
+bool BitBoard::occupied(int index) const {
+    return occupied_word(index >> 6) & (1ull << (index & 63));
+}
+
+bool BitBoard::test(CellPlane plane, int index) const {
+    return m_words[(index >> 6)*PLANE_COUNT + plane] & (1ull << (index & 63));
+}
+
+int BitBoard::count(CellPlane plane) const {
+    int total = 0;
+    for (std::size_t w = plane; w < m_words.size(); w += PLANE_COUNT) {
+        total += std::popcount(m_words[w]);
+    }
+    return total;
+}
+
+int BitBoard::count_occupied() const {
+    int total = 0;
+    int blocks = m_words.size() / PLANE_COUNT;
+    for (int b = 0; b < blocks; b++) {
+        total += std::popcount(occupied_word(b));
+    }
+    return total;
+}
+
+int BitBoard::find_first_occupied(int low, int high) const {
+    // masks off the bits below low in the first word, then skips whole empty words
+    if (low > high) {
+        return -1;
+    }
+    int block = low >> 6;
+    int last_block = high >> 6;
+    uint64_t word = occupied_word(block) & (~0ull << (low & 63));
+    while (!word) {
+        block++;
+        if (block > last_block) {
+            return -1;
+        }
+        word = occupied_word(block);
+    }
+    int index = (block << 6) + std::countr_zero(word);
+    return index <= high ? index : -1;
+}
+
+int BitBoard::find_last_occupied(int low, int high) const {
+    // same as find_first_occupied, walking down from high
+    if (low > high) {
+        return -1;
+    }
+    int block = high >> 6;
+    int first_block = low >> 6;
+    uint64_t word = occupied_word(block) & (~0ull >> (63 - (high & 63)));
+    while (!word) {
+        block--;
+        if (block < first_block) {
+            return -1;
+        }
+        word = occupied_word(block);
+    }
+    int index = (block << 6) + 63 - std::countl_zero(word);
+    return index >= low ? index : -1;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// one bit plane per kind of thing that can be in a cell
+enum CellPlane { PLANE_ROBOT, PLANE_DEAD, PLANE_MOUND, PLANE_PIT, PLANE_FLAME, PLANE_COUNT };
+
+// the board as bit planes, 64 cells per word. the planes for each block of 64 cells sit
+// next to each other in memory, so "is anything here" is an OR of neighbouring words and
+// emptiness checks, counts and scans go a word at a time instead of a cell at a time.
+// cells are numbered row major like Arena::pos_to_index.
+class BitBoard {
+private:
+    int m_cells;
+    std::vector<uint64_t> m_words;  // block b, plane p lives at m_words[b*PLANE_COUNT + p]
+    uint64_t occupied_word(int block) const;
+public:
+    BitBoard();
+    void reset(int cells);
+    int size() const;
+    // '.', 'R', 'X', 'M', 'P' or 'F'
+    char get(int index) const;
+    void set(int index, char type);
+    bool occupied(int index) const;
+    bool test(CellPlane plane, int index) const;
+    int count(CellPlane plane) const;
+    int count_occupied() const;
+    // lowest (or highest) occupied cell in [low, high], -1 if there is none
+    int find_first_occupied(int low, int high) const;
+    int find_last_occupied(int low, int high) const;
+    static CellPlane plane_of(char type);
+};
@@ -0,0 +1,64 @@
+#include <algorithm>
+
+#include "BoardIndex.h"
+
+BoardIndex::BoardIndex() : m_height(0), m_width(0) {}
+
+void BoardIndex::reset(int height, int width) {
+    m_height = height;
+    m_width = width;
+    m_cols.assign(width, std::vector<int>());
+    m_diags.assign(height + width - 1, std::vector<int>());
+    m_anti_diags.assign(height + width - 1, std::vector<int>());
+}
+
+void BoardIndex::rebuild(const BitBoard& board) {
+    // walks the occupied cells in board order, so rows only ever grow and every line stays sorted
+    reset(m_height, m_width);
+    int cells = m_height*m_width;
+    for (int index = board.find_first_occupied(0, cells - 1); index >= 0; index = board.find_first_occupied(index + 1, cells - 1)) {
+        int row = index / m_width;
+        int col = index % m_width;
+        m_cols[col].push_back(row);
+        m_diags[row - col + m_width - 1].push_back(row);
+        m_anti_diags[row + col].push_back(row);
+    }
+}
+
+std::vector<int>& BoardIndex::line(int row, int col, int d_row, int d_col, int& position) {
+    // picks the family from the step: down a column, or one of the diagonals
+    position = row;
+    if (d_col == 0) {
+        return m_cols[col];
+    }
+    if (d_row == d_col) {
+        return m_diags[row - col + m_width - 1];
+    }
+    return m_anti_diags[row + col];
+}
+
+void BoardIndex::insert(int row, int col) {
+    // the same cell goes on all three of its lines, each kept sorted
+    const int steps[3][2] = {{1, 0}, {1, 1}, {1, -1}};
+    for (int i = 0; i < 3; i++) {
+        int position;
+        std::vector<int>& cells = line(row, col, steps[i][0], steps[i][1], position);
+        cells.insert(std::lower_bound(cells.begin(), cells.end(), position), position);
+    }
+}
+
+void BoardIndex::erase(int row, int col) {
+    const int steps[3][2] = {{1, 0}, {1, 1}, {1, -1}};
+    for (int i = 0; i < 3; i++) {
+        int position;
+        std::vector<int>& cells = line(row, col, steps[i][0], steps[i][1], position);
+        std::vector<int>::iterator it = std::lower_bound(cells.begin(), cells.end(), position);
+        if (it != cells.end() && *it == position) {
+            cells.erase(it);
+        }
+    }
+}
+
+const std::vector<int>& BoardIndex::find_line(int row, int col, int d_row, int d_col, int& position) {
+    return line(row, col, d_row, d_col, position);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+#include "BitBoard.h"
+
+// sorted positions of every non-empty cell along each column and diagonal of the board.
+// a radar ray runs along one of these lines, so it can jump from object to object
+// instead of reading every empty cell between them. rows need no index, the bit board
+// already keeps each row's cells next to each other.
+class BoardIndex {
+private:
+    int m_height;
+    int m_width;
+    std::vector<std::vector<int>> m_cols;       // rows in use in each column
+    std::vector<std::vector<int>> m_diags;      // rows in use on each down-right diagonal, by row - col + width - 1
+    std::vector<std::vector<int>> m_anti_diags; // rows in use on each down-left diagonal, by row + col
+    std::vector<int>& line(int row, int col, int d_row, int d_col, int& position);
+public:
+    BoardIndex();
+    void reset(int height, int width);
+    // rebuilds every line from the board in one pass, much cheaper than inserting a crowd one by one
+    void rebuild(const BitBoard& board);
+    void insert(int row, int col);
+    void erase(int row, int col);
+    // the line through (row, col) that steps by (d_row, d_col). d_row must not be 0.
+    // position is where (row, col) sits on it, which is its row.
+    const std::vector<int>& find_line(int row, int col, int d_row, int d_col, int& position);
+};
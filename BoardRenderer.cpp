@@ -0,0 +1,173 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "BoardRenderer.h"
+
+// lines the turn log keeps under an in place board, fewer than this and frames are printed in full
+const int MIN_LOG_ROWS = 5;
+
+BoardRenderer::BoardRenderer() : m_height(0), m_width(0), m_prefix(0), m_in_place(false), m_drawn(false), m_screen_rows(0) {}
+
+void BoardRenderer::reset(int height, int width, bool in_place) {
+    // sizes everything for the board up front so drawing a frame never allocates
+    m_height = height;
+    m_width = width;
+    m_prefix = std::to_string(std::max(height - 1, 0)).size() + 2;
+    m_drawn = false;
+    m_next.assign(height*width*2, ' ');
+    m_shown.assign(height*width*2, '\0');
+
+    m_in_place = false;
+    struct winsize size;
+    if (in_place && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+        m_screen_rows = size.ws_row;
+        m_in_place = height + 1 + MIN_LOG_ROWS <= size.ws_row && m_prefix + 3*width <= size.ws_col;
+    }
+
+    // a full frame is the biggest thing drawn, unless nearly every cell changes in place
+    size_t full = (2*height + 2) * (m_prefix + 3*width + 2);
+    size_t diff = height*width * 16 + 16;
+    m_frame.clear();
+    m_frame.reserve(std::max(full, diff));
+}
+
+int BoardRenderer::height() {
+    return m_height;
+}
+
+int BoardRenderer::width() {
+    return m_width;
+}
+
+void BoardRenderer::set_cell(int row, int col, char type, char robot) {
+    int index = (row*m_width + col)*2;
+    m_next[index] = type;
+    m_next[index + 1] = robot;
+}
+
+void BoardRenderer::append_number(int number) {
+    // the frame only ever needs small non negative numbers
+    char digits[12];
+    int count = 0;
+    do {
+        digits[count++] = '0' + number % 10;
+        number /= 10;
+    } while (number > 0);
+    while (count > 0) {
+        m_frame.push_back(digits[--count]);
+    }
+}
+
+void BoardRenderer::build_full_frame() {
+    // the layout Arena::display_board has always printed
+    m_frame += "\n   ";
+    for (int cl = 0; cl < m_width; cl++) {
+        if (cl < 10) {
+            m_frame += ' ';
+            append_number(cl);
+            m_frame += ' ';
+        } else {
+            append_number(cl);
+            m_frame += ' ';
+        }
+    }
+    m_frame += '\n';
+    for (int rw = 0; rw < m_height; rw++) {
+        append_number(rw);
+        m_frame += "  ";
+        for (int cl = 0; cl < m_width; cl++) {
+            int index = (rw*m_width + cl)*2;
+            m_frame += ' ';
+            m_frame += m_next[index];
+            m_frame += m_next[index + 1];
+        }
+        m_frame += "\n\n";
+    }
+}
+
+void BoardRenderer::build_first_frame() {
+    // clears the screen and draws the board one line per row, with the row numbers lined up
+    // then fences off the rest of the screen as a scroll region for the turn log
+    m_frame += "\x1b[2J\x1b[H";
+    m_frame.append(m_prefix, ' ');
+    for (int cl = 0; cl < m_width; cl++) {
+        if (cl < 10) {
+            m_frame += ' ';
+        }
+        append_number(cl);
+        m_frame += ' ';
+    }
+    for (int rw = 0; rw < m_height; rw++) {
+        m_frame += '\n';
+        std::string number = std::to_string(rw);
+        m_frame += number;
+        m_frame.append(m_prefix - number.size(), ' ');
+        for (int cl = 0; cl < m_width; cl++) {
+            int index = (rw*m_width + cl)*2;
+            m_frame += ' ';
+            m_frame += m_next[index];
+            m_frame += m_next[index + 1];
+        }
+    }
+    m_frame += "\x1b[";
+    append_number(m_height + 2);
+    m_frame += ';';
+    append_number(m_screen_rows);
+    m_frame += "r\x1b[";
+    append_number(m_height + 2);
+    m_frame += ";1H";
+}
+
+void BoardRenderer::build_diff_frame() {
+    // saves the log's cursor, rewrites just the changed cells, and puts the cursor back
+    m_frame += "\x1b" "7";
+    for (int rw = 0; rw < m_height; rw++) {
+        for (int cl = 0; cl < m_width; cl++) {
+            int index = (rw*m_width + cl)*2;
+            if (m_next[index] == m_shown[index] && m_next[index + 1] == m_shown[index + 1]) {
+                continue;
+            }
+            m_frame += "\x1b[";
+            append_number(rw + 2);
+            m_frame += ';';
+            append_number(m_prefix + 3*cl + 2);
+            m_frame += 'H';
+            m_frame += m_next[index];
+            m_frame += m_next[index + 1];
+        }
+    }
+    m_frame += "\x1b" "8";
+}
+
+void BoardRenderer::draw() {
+    // builds the frame, then hands it to the stream with a single write and flush
+    m_frame.clear();
+    if (!m_in_place) {
+        build_full_frame();
+    } else if (!m_drawn) {
+        build_first_frame();
+        m_drawn = true;
+    } else {
+        build_diff_frame();
+    }
+    m_shown = m_next;
+    std::cout.write(m_frame.data(), m_frame.size());
+    std::cout.flush();
+}
+
+void BoardRenderer::finish() {
+    // drops the scroll region and leaves the cursor at the bottom of the screen
+    if (m_in_place && m_drawn) {
+        m_frame.clear();
+        m_frame += "\x1b[r\x1b[";
+        append_number(m_screen_rows);
+        m_frame += ";1H\n";
+        std::cout.write(m_frame.data(), m_frame.size());
+        std::cout.flush();
+        m_drawn = false;
+    }
+}
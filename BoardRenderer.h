@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// draws the board for live viewing. each frame is built into one buffer that is
+// allocated once, then written and flushed in one go.
+// on a terminal the board is drawn once at the top of the screen and every frame
+// after that only rewrites the cells that changed, using cursor moves; the turn log
+// scrolls in the region underneath. anywhere else (a pipe, a file, a terminal too
+// small for the board) every frame is printed in full, laid out like it always was.
+class BoardRenderer {
+private:
+    int m_height;
+    int m_width;
+    int m_prefix;               // width of the row number column when drawing in place
+    bool m_in_place;
+    bool m_drawn;               // the first in place frame has been drawn
+    int m_screen_rows;
+    std::vector<char> m_next;   // two characters per cell: the cell type and the robot character
+    std::vector<char> m_shown;  // the same for what is on screen now
+    std::string m_frame;
+    void append_number(int number);
+    void build_full_frame();
+    void build_first_frame();
+    void build_diff_frame();
+public:
+    BoardRenderer();
+    // in_place asks for cursor drawing, it is only used if the board fits on the terminal
+    void reset(int height, int width, bool in_place);
+    int height();
+    int width();
+    void set_cell(int row, int col, char type, char robot);
+    void draw();
+    // gives the whole screen back to normal output once the match is over
+    void finish();
+};
@@ -0,0 +1,292 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ConsoleLog.h"
+
+// the lowest level each event type shows up at, in ConsoleEventType order
+static const int EVENT_LEVELS[CONSOLE_EVENT_TYPES] = {
+    LOG_BOARD,  // round
+    LOG_BOARD,  // board
+    LOG_TURNS,  // turn
+    LOG_TURNS,  // out
+    LOG_TURNS,  // status
+    LOG_RADAR,  // radar
+    LOG_RADAR,  // radar object
+    LOG_TURNS,  // firing
+    LOG_TURNS,  // not firing
+    LOG_TURNS,  // moving
+    LOG_TURNS,  // hit
+    LOG_TURNS,  // shot end
+    LOG_TURNS,  // no grenades
+    LOG_TURNS,  // shot down
+    LOG_TURNS,  // forfeit
+    LOG_TURNS,  // stopped
+    LOG_BOARD,  // winner
+    LOG_BOARD   // out of rounds
+};
+
+ConsoleLog::ConsoleLog()
+    : m_head(0), m_tail(0), m_wakeups(0), m_sleeping(false), m_stopping(false),
+      m_level(LOG_RADAR), m_running(false), m_next_frame(0) {
+    m_frame_busy[0] = false;
+    m_frame_busy[1] = false;
+}
+
+ConsoleLog::~ConsoleLog() {
+    stop();
+}
+
+void ConsoleLog::set_level(int level) {
+    // safe to call from any thread at any time, events already queued still print
+    m_level.store(level, std::memory_order_relaxed);
+}
+
+int ConsoleLog::get_level() {
+    return m_level.load(std::memory_order_relaxed);
+}
+
+bool ConsoleLog::enabled(ConsoleEventType type) {
+    return m_level.load(std::memory_order_relaxed) >= EVENT_LEVELS[type];
+}
+
+void ConsoleLog::set_robots(const std::vector<std::string>& names, const std::vector<char>& characters) {
+    // the formatter reads these, so it has to be idle while they change
+    flush();
+    m_names = names;
+    m_characters = characters;
+}
+
+void ConsoleLog::set_board(int height, int width, bool in_place) {
+    flush();
+    m_renderer.reset(height, width, in_place);
+    m_frames[0].assign(height*width*2, ' ');
+    m_frames[1].assign(height*width*2, ' ');
+}
+
+bool ConsoleLog::board_is(int height, int width) {
+    return m_renderer.height() == height && m_renderer.width() == width;
+}
+
+void ConsoleLog::start() {
+    if (m_running) {
+        return;
+    }
+    // the ring is only needed once there is a formatter, so headless arenas never pay for it
+    if (m_queue.empty()) {
+        m_queue.resize(CONSOLE_QUEUE_EVENTS);
+    }
+    m_stopping = false;
+    m_running = true;
+    m_thread = std::thread(&ConsoleLog::run, this);
+}
+
+void ConsoleLog::stop() {
+    // the formatter writes out whatever is still queued before it exits
+    // the board then gets the whole screen back
+    if (!m_running) {
+        m_renderer.finish();
+        return;
+    }
+    m_stopping = true;
+    m_wakeups.fetch_add(1);
+    m_wakeups.notify_one();
+    m_thread.join();
+    m_running = false;
+    m_renderer.finish();
+}
+
+void ConsoleLog::flush() {
+    // waits until the formatter has written everything pushed so far
+    if (!m_running) {
+        std::cout.flush();
+        return;
+    }
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t tail = m_tail.load();
+    while (tail != head) {
+        m_tail.wait(tail);
+        tail = m_tail.load();
+    }
+}
+
+void ConsoleLog::push(ConsoleEventType type, int robot, char detail, int v0, int v1, int v2, int v3) {
+    // filtered here, so a level that hides an event costs next to nothing
+    if (!enabled(type)) {
+        return;
+    }
+    ConsoleEvent event {type, detail, static_cast<int16_t>(robot), {v0, v1, v2, v3}};
+    if (!m_running) {
+        format(event);
+        write_text();
+        return;
+    }
+    // only waits if the formatter is a whole queue behind
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t tail = m_tail.load();
+    while (head - tail >= CONSOLE_QUEUE_EVENTS) {
+        m_tail.wait(tail);
+        tail = m_tail.load();
+    }
+    m_queue[head % CONSOLE_QUEUE_EVENTS] = event;
+    m_head.store(head + 1);
+    // the formatter only needs waking if it went to sleep on an empty queue
+    if (m_sleeping.load()) {
+        m_wakeups.fetch_add(1);
+        m_wakeups.notify_one();
+    }
+}
+
+char* ConsoleLog::begin_frame() {
+    // the buffer that isn't being drawn, waiting if the formatter is still on it
+    bool busy = m_frame_busy[m_next_frame].load();
+    while (busy) {
+        m_frame_busy[m_next_frame].wait(true);
+        busy = m_frame_busy[m_next_frame].load();
+    }
+    return m_frames[m_next_frame].data();
+}
+
+void ConsoleLog::end_frame() {
+    if (!enabled(CONSOLE_BOARD)) {
+        return;
+    }
+    if (!m_running) {
+        push(CONSOLE_BOARD, -1, 0, m_next_frame);
+        return;
+    }
+    m_frame_busy[m_next_frame] = true;
+    push(CONSOLE_BOARD, -1, 0, m_next_frame);
+    m_next_frame ^= 1;
+}
+
+void ConsoleLog::run() {
+    // takes everything queued in one go, formats it into one string and writes that
+    // sleeps when there is nothing to do and leaves once stopped with the queue empty
+    while (true) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load();
+        if (head == tail) {
+            if (m_stopping.load()) {
+                break;
+            }
+            uint32_t wakeups = m_wakeups.load();
+            m_sleeping.store(true);
+            if (m_head.load() == tail && !m_stopping.load()) {
+                m_wakeups.wait(wakeups);
+            }
+            m_sleeping.store(false);
+            continue;
+        }
+        for (; tail != head; tail++) {
+            format(m_queue[tail % CONSOLE_QUEUE_EVENTS]);
+        }
+        write_text();
+        m_tail.store(head);
+        m_tail.notify_all();
+    }
+}
+
+void ConsoleLog::write_text() {
+    if (!m_text.empty()) {
+        std::cout.write(m_text.data(), m_text.size());
+        m_text.clear();
+    }
+    std::cout.flush();
+}
+
+void ConsoleLog::format(const ConsoleEvent& event) {
+    // the same wording the arena has always printed
+    const int* v = event.values;
+    static const std::string no_name;
+    const std::string& name = event.robot >= 0 && event.robot < static_cast<int>(m_names.size()) ? m_names[event.robot] : no_name;
+    switch (event.type) {
+        case CONSOLE_ROUND:
+            m_text += "         =========== starting round " + std::to_string(v[0]) + " ===========";
+            break;
+        case CONSOLE_BOARD: {
+            // text queued ahead of the frame has to reach the screen first
+            write_text();
+            const std::vector<char>& frame = m_frames[v[0]];
+            int width = m_renderer.width();
+            for (int rw = 0; rw < m_renderer.height(); rw++) {
+                for (int cl = 0; cl < width; cl++) {
+                    int index = (rw*width + cl)*2;
+                    m_renderer.set_cell(rw, cl, frame[index], frame[index + 1]);
+                }
+            }
+            m_renderer.draw();
+            m_frame_busy[v[0]] = false;
+            m_frame_busy[v[0]].notify_all();
+            break;
+        }
+        case CONSOLE_TURN:
+            m_text += name + " ";
+            if (event.robot >= 0 && event.robot < static_cast<int>(m_characters.size())) {
+                m_text += m_characters[event.robot];
+            }
+            m_text += " (" + std::to_string(v[0]) + "," + std::to_string(v[1]) + ")";
+            break;
+        case CONSOLE_OUT:
+            m_text += " - is out\n\n";
+            break;
+        case CONSOLE_STATUS:
+            m_text += " Health: " + std::to_string(v[0]) + " Armor: " + std::to_string(v[1]) + "\n";
+            break;
+        case CONSOLE_RADAR:
+            m_text += "\tradar scan returned ";
+            if (v[0] == 0) {
+                m_text += "nothing\n";
+            }
+            break;
+        case CONSOLE_RADAR_OBJECT:
+            if (v[2] > 0) {
+                m_text += ", and ";
+            }
+            m_text += event.detail;
+            m_text += " at (" + std::to_string(v[0]) + "," + std::to_string(v[1]) + ")";
+            if (v[2] == v[3] - 1) {
+                m_text += "\n";
+            }
+            break;
+        case CONSOLE_FIRING:
+            m_text += "\tfiring " + std::to_string(v[0]) + " at (" + std::to_string(v[1]) + "," + std::to_string(v[2]) + ")\n";
+            break;
+        case CONSOLE_NOT_FIRING:
+            m_text += "\tnot firing\n";
+            break;
+        case CONSOLE_MOVING:
+            m_text += "\tmoving to (" + std::to_string(v[0]) + "," + std::to_string(v[1]) + ")\n\n";
+            break;
+        case CONSOLE_HIT:
+            m_text += "\thit " + name + " for " + std::to_string(v[0]) + " damage\n";
+            break;
+        case CONSOLE_SHOT_END:
+            m_text += v[0] == 0 ? "\tdid not deal damage\n\n" : "\n";
+            break;
+        case CONSOLE_NO_GRENADES:
+            m_text += "\tout of grenades\n\n";
+            break;
+        case CONSOLE_SHOT_DOWN:
+            m_text += "\tshot down before it could move\n\n";
+            break;
+        case CONSOLE_FORFEIT:
+            m_text += "\tover the turn budget, turn forfeited\n\n";
+            break;
+        case CONSOLE_STOPPED:
+            m_text += "\t" + name + " stopped responding and is out\n\n";
+            break;
+        case CONSOLE_WINNER:
+            if (event.robot < 0) {
+                m_text += "End of game! No robots left standing.\n";
+            } else {
+                m_text += "End of game! " + name + " Wins!!!\n";
+            }
+            break;
+        case CONSOLE_OUT_OF_ROUNDS:
+            m_text += "End of game! Out of rounds after " + std::to_string(v[0]) + ".\n";
+            break;
+        default:
+            break;
+    }
+}
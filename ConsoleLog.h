@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+#include "BoardRenderer.h"
+
+// how much of a match gets printed. each level adds to the one before
+enum LogLevel {
+    LOG_QUIET = 0,      // nothing
+    LOG_BOARD,          // round banners, the board and how the match ended
+    LOG_TURNS,          // what every robot did on its turn
+    LOG_RADAR           // and what its radar saw
+};
+
+// events waiting in the queue, small enough to copy around freely
+const uint32_t CONSOLE_QUEUE_EVENTS = 1 << 14;
+
+enum ConsoleEventType : uint8_t {
+    CONSOLE_ROUND,          // values: round
+    CONSOLE_BOARD,          // values: frame buffer
+    CONSOLE_TURN,           // robot, values: row, col
+    CONSOLE_OUT,            // robot is out, it skips its turn
+    CONSOLE_STATUS,         // values: health, armor
+    CONSOLE_RADAR,          // values: objects found
+    CONSOLE_RADAR_OBJECT,   // detail: cell type, values: row, col, index, objects found
+    CONSOLE_FIRING,         // values: weapon, row, col
+    CONSOLE_NOT_FIRING,
+    CONSOLE_MOVING,         // values: row, col
+    CONSOLE_HIT,            // robot was hit, values: damage
+    CONSOLE_SHOT_END,       // values: robots hit
+    CONSOLE_NO_GRENADES,
+    CONSOLE_SHOT_DOWN,      // robot went down in the shots before it could move
+    CONSOLE_FORFEIT,
+    CONSOLE_STOPPED,        // robot stopped responding
+    CONSOLE_WINNER,         // robot won, -1 if nobody is left
+    CONSOLE_OUT_OF_ROUNDS,  // values: round
+    CONSOLE_EVENT_TYPES
+};
+
+struct ConsoleEvent {
+    uint8_t type;
+    char detail;
+    int16_t robot;
+    int32_t values[4];
+};
+
+// the live turn log. the arena pushes small events into a single producer, single
+// consumer ring and a background thread turns them into text and writes them in
+// batches, so the match never waits on the terminal. board frames are handed over
+// through a pair of buffers: the arena fills one while the other is being drawn.
+// before start (and after stop) events are formatted and written on the spot,
+// which is also what a match that isn't watched live gets.
+class ConsoleLog {
+private:
+    std::vector<ConsoleEvent> m_queue;  // CONSOLE_QUEUE_EVENTS long once start has run
+    std::atomic<uint32_t> m_head;       // events pushed, only the arena writes it
+    std::atomic<uint32_t> m_tail;       // events written out, only the formatter writes it
+    std::atomic<uint32_t> m_wakeups;    // bumped to wake the formatter
+    std::atomic<bool> m_sleeping;       // the formatter is waiting for a wakeup
+    std::atomic<bool> m_stopping;
+    std::atomic<int> m_level;
+    bool m_running;
+    std::thread m_thread;
+    std::vector<std::string> m_names;
+    std::vector<char> m_characters;
+    BoardRenderer m_renderer;
+    std::vector<char> m_frames[2];
+    std::atomic<bool> m_frame_busy[2];
+    int m_next_frame;
+    std::string m_text;
+    void run();
+    void format(const ConsoleEvent& event);
+    void write_text();
+public:
+    ConsoleLog();
+    virtual ~ConsoleLog();
+    void set_level(int level);
+    int get_level();
+    bool enabled(ConsoleEventType type);
+    void set_robots(const std::vector<std::string>& names, const std::vector<char>& characters);
+    void set_board(int height, int width, bool in_place);
+    bool board_is(int height, int width);
+    void start();
+    void stop();
+    void flush();
+    void push(ConsoleEventType type, int robot = -1, char detail = 0, int v0 = 0, int v1 = 0, int v2 = 0, int v3 = 0);
+    // a frame is two characters per cell, the cell type and the robot character
+    char* begin_frame();
+    void end_frame();
+};
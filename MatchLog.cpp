@@ -0,0 +1,178 @@
+#include <iostream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MatchLog.h"
+
+MatchLogWriter::MatchLogWriter() {}
+
+MatchLogWriter::~MatchLogWriter() {
+    close();
+}
+
+bool MatchLogWriter::open(const std::string& path, const MatchLogHeader& header, const std::vector<MatchLogRobot>& robots) {
+    // the header and robot table go out straight away, the events as the buffer fills
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        std::cerr << "Could not open match log " << path << std::endl;
+        return false;
+    }
+    m_buffer.reserve(MATCH_LOG_BUFFER_EVENTS);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(reinterpret_cast<const char*>(robots.data()), robots.size() * sizeof(MatchLogRobot));
+    return true;
+}
+
+bool MatchLogWriter::is_open() {
+    return m_file.is_open();
+}
+
+void MatchLogWriter::write(uint8_t type, int robot, int detail, int v0, int v1, int v2, int v3) {
+    if (!m_file.is_open()) {
+        return;
+    }
+    m_buffer.push_back(MatchEvent {type, static_cast<int8_t>(detail), static_cast<int16_t>(robot), {v0, v1, v2, v3}});
+    if (m_buffer.size() >= MATCH_LOG_BUFFER_EVENTS) {
+        flush();
+    }
+}
+
+void MatchLogWriter::flush() {
+    if (!m_buffer.empty()) {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(MatchEvent));
+        m_buffer.clear();
+    }
+    m_file.flush();
+}
+
+void MatchLogWriter::close() {
+    if (m_file.is_open()) {
+        flush();
+        m_file.close();
+    }
+}
+
+MatchLogView::MatchLogView() : m_data(nullptr), m_size(0) {}
+
+MatchLogView::~MatchLogView() {
+    close();
+}
+
+bool MatchLogView::open(const std::string& path) {
+    // maps the whole file and checks that the header and robot table fit and make sense
+    // a partly written last event (a match cut off mid write) is simply not counted
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Could not open match log " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(MatchLogHeader)) {
+        std::cerr << path << " is too short to be a match log" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    m_size = info.st_size;
+    m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m_data == MAP_FAILED) {
+        std::cerr << "Could not map match log " << path << std::endl;
+        m_data = nullptr;
+        m_size = 0;
+        return false;
+    }
+    const MatchLogHeader& log_header = header();
+    if (std::memcmp(log_header.magic, MATCH_LOG_MAGIC, sizeof(MATCH_LOG_MAGIC)) != 0
+        || log_header.robot_count < 0 || log_header.height <= 0 || log_header.width <= 0
+        || m_size < sizeof(MatchLogHeader) + log_header.robot_count * sizeof(MatchLogRobot)) {
+        std::cerr << path << " is not a match log this version can read" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MatchLogView::close() {
+    if (m_data) {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+const MatchLogHeader& MatchLogView::header() const {
+    return *static_cast<const MatchLogHeader*>(m_data);
+}
+
+const MatchLogRobot* MatchLogView::robots() const {
+    return reinterpret_cast<const MatchLogRobot*>(static_cast<const char*>(m_data) + sizeof(MatchLogHeader));
+}
+
+const MatchEvent* MatchLogView::events() const {
+    return reinterpret_cast<const MatchEvent*>(robots() + header().robot_count);
+}
+
+size_t MatchLogView::event_count() const {
+    size_t start = sizeof(MatchLogHeader) + header().robot_count * sizeof(MatchLogRobot);
+    return (m_size - start) / sizeof(MatchEvent);
+}
+
+void reset_replay(ReplayBoard& board, const MatchLogHeader& header) {
+    board.height = header.height;
+    board.width = header.width;
+    board.cells.assign(board.height*board.width, '.');
+    board.cell_robot.assign(board.height*board.width, -1);
+    board.damage_dealt.assign(header.robot_count, 0);
+    board.damage_taken.assign(header.robot_count, 0);
+}
+
+static int cell_index(const ReplayBoard& board, int row, int col) {
+    // -1 for anything off the board, so a damaged log can't write outside it
+    if (row < 0 || row >= board.height || col < 0 || col >= board.width) {
+        return -1;
+    }
+    return row*board.width + col;
+}
+
+static bool is_robot(const ReplayBoard& board, int robot) {
+    return robot >= 0 && robot < static_cast<int>(board.damage_taken.size());
+}
+
+void apply_event(ReplayBoard& board, const MatchEvent& event) {
+    // damage is counted the way the arena counts it, a robot hurting itself deals nothing
+    int from = cell_index(board, event.values[0], event.values[1]);
+    int to = cell_index(board, event.values[2], event.values[3]);
+    switch (event.type) {
+        case EVENT_CELL:
+            if (from >= 0) {
+                board.cells[from] = event.detail;
+            }
+            break;
+        case EVENT_PLACE:
+            if (from >= 0) {
+                board.cell_robot[from] = event.robot;
+            }
+            break;
+        case EVENT_MOVE:
+            if (from >= 0) {
+                board.cell_robot[from] = -1;
+            }
+            if (to >= 0) {
+                board.cell_robot[to] = event.robot;
+            }
+            break;
+        case EVENT_DAMAGE:
+            if (is_robot(board, event.robot)) {
+                board.damage_taken[event.robot] += event.values[1];
+            }
+            if (is_robot(board, event.values[0]) && event.values[0] != event.robot) {
+                board.damage_dealt[event.values[0]] += event.values[1];
+            }
+            break;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+// first bytes of every match log, bumped whenever a record layout changes
+const char MATCH_LOG_MAGIC[8] = {'R', 'W', 'Z', 'L', 'O', 'G', '0', '1'};
+
+// how many events the writer holds before it goes to the file
+const size_t MATCH_LOG_BUFFER_EVENTS = 4096;
+
+// a log is a header, one MatchLogRobot per robot, then MatchEvents until the end of the file.
+// everything is fixed size and written in the machine's own byte order
+struct MatchLogHeader {
+    char magic[8];
+    int32_t height;
+    int32_t width;
+    int32_t robot_count;
+    int32_t reserved;
+    uint64_t seed;
+};
+
+struct MatchLogRobot {
+    char name[32];
+    char character;
+    int8_t weapon;
+    int16_t reserved;
+};
+
+// what each event holds in detail and values
+enum MatchEventType : uint8_t {
+    EVENT_ROUND = 1,    // values: round
+    EVENT_CELL,         // detail: new cell character, values: row, col
+    EVENT_PLACE,        // robot placed, values: row, col
+    EVENT_RADAR,        // detail: direction, values: row, col, objects found
+    EVENT_SHOT,         // detail: weapon, values: aim row, aim col
+    EVENT_HIT,          // robot hit, values: attacker (-1 for the arena), damage rolled
+    EVENT_DAMAGE,       // values: attacker, damage after armor, health left, armor left
+    EVENT_MOVE,         // values: from row, from col, to row, to col
+    EVENT_DEATH,        // values: row, col
+    EVENT_END           // values: winner (-1 for none), rounds
+};
+
+struct MatchEvent {
+    uint8_t type;
+    int8_t detail;
+    int16_t robot;      // -1 when the event is not about one robot
+    int32_t values[4];
+};
+
+static_assert(sizeof(MatchLogHeader) == 32, "match log header layout changed");
+static_assert(sizeof(MatchLogRobot) == 36, "match log robot layout changed");
+static_assert(sizeof(MatchEvent) == 20, "match log event layout changed");
+
+// appends a match to a log file. events are gathered in a buffer and written
+// in blocks, so logging a turn costs a few stores rather than a write call
+class MatchLogWriter {
+private:
+    std::ofstream m_file;
+    std::vector<MatchEvent> m_buffer;
+public:
+    MatchLogWriter();
+    virtual ~MatchLogWriter();
+    bool open(const std::string& path, const MatchLogHeader& header, const std::vector<MatchLogRobot>& robots);
+    bool is_open();
+    void write(uint8_t type, int robot, int detail, int v0 = 0, int v1 = 0, int v2 = 0, int v3 = 0);
+    void flush();
+    void close();
+};
+
+// a read only view of a log file mapped straight into memory, nothing is copied
+class MatchLogView {
+private:
+    void* m_data;
+    size_t m_size;
+public:
+    MatchLogView();
+    virtual ~MatchLogView();
+    bool open(const std::string& path);
+    void close();
+    const MatchLogHeader& header() const;
+    const MatchLogRobot* robots() const;
+    const MatchEvent* events() const;
+    size_t event_count() const;
+};
+
+// a match rebuilt from its log: the board from cell, place and move events, and every
+// robot's damage from its damage events. RobotReplay draws and sums up matches from it
+struct ReplayBoard {
+    int height;
+    int width;
+    std::vector<char> cells;
+    std::vector<int> cell_robot;    // robot index by cell, -1 for none
+    std::vector<int> damage_dealt;  // per robot
+    std::vector<int> damage_taken;
+};
+
+// an empty board the size the header gives, before any event
+void reset_replay(ReplayBoard& board, const MatchLogHeader& header);
+
+// plays one event onto the board, events that change nothing it keeps are skipped
+void apply_event(ReplayBoard& board, const MatchEvent& event);
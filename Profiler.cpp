@@ -0,0 +1,176 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "Profiler.h"
+
+static const char* PHASE_NAMES[PHASE_COUNT] = {"callbacks", "radar", "shots", "damage", "moves", "render"};
+static const char* COUNTER_NAMES[COUNTER_COUNT] = {"cells_scanned", "radar_objects", "shots", "hits", "moves", "allocations"};
+
+// all null until AllocationCounter.o installs itself, if it was linked in at all
+static AllocationCounter g_counter = {nullptr, nullptr, nullptr};
+
+void install_allocation_counter(const AllocationCounter& counter) {
+    g_counter = counter;
+}
+
+bool allocations_counted() {
+    return g_counter.set_counting != nullptr;
+}
+
+void count_allocations(bool on) {
+    if (g_counter.set_counting) {
+        g_counter.set_counting(on);
+    }
+}
+
+long long allocation_count() {
+    return g_counter.process_count ? g_counter.process_count() : 0;
+}
+
+long long thread_allocation_count() {
+    return g_counter.thread_count ? g_counter.thread_count() : 0;
+}
+
+Profiler::Profiler() : m_enabled(false), m_counting(false), m_start_allocations(0) {
+    m_slots.assign(1, Slot {});
+}
+
+Profiler::~Profiler() {
+    if (m_counting) {
+        count_allocations(false);
+    }
+}
+
+void Profiler::set_enabled(bool enabled) {
+    m_enabled = enabled;
+}
+
+void Profiler::start(int robots) {
+    m_slots.assign(robots + 1, Slot {});
+    if (m_enabled && !m_counting) {
+        count_allocations(true);
+        m_counting = true;
+        m_start_allocations = allocation_count();
+    }
+}
+
+void Profiler::finish() {
+    if (m_counting) {
+        m_slots[0].counters[COUNT_ALLOCATIONS] = allocation_count() - m_start_allocations;
+        count_allocations(false);
+        m_counting = false;
+    }
+}
+
+Profiler::Slot Profiler::total() const {
+    Slot sum {};
+    for (const Slot& slot : m_slots) {
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            sum.phase_ns[p] += slot.phase_ns[p];
+            sum.phase_calls[p] += slot.phase_calls[p];
+            sum.phase_allocations[p] += slot.phase_allocations[p];
+        }
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            sum.counters[c] += slot.counters[c];
+        }
+    }
+    return sum;
+}
+
+void Profiler::print_report(std::ostream& out, const std::vector<std::string>& names) const {
+    // the phases with their share of the profiled time, the counters, then a line per robot
+    Slot sum = total();
+    int64_t profiled_ns = 0;
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        profiled_ns += sum.phase_ns[p];
+    }
+    out << std::endl << std::left << std::setw(20) << "Phase" << std::right
+        << std::setw(12) << "Calls" << std::setw(12) << "Total ms" << std::setw(10) << "Avg us" << std::setw(8) << "%" << std::setw(10) << "Allocs" << std::endl;
+    out << std::fixed;
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        out << std::left << std::setw(20) << PHASE_NAMES[p] << std::right
+            << std::setw(12) << sum.phase_calls[p]
+            << std::setw(12) << std::setprecision(2) << sum.phase_ns[p] / 1e6
+            << std::setw(10) << std::setprecision(2) << (sum.phase_calls[p] ? sum.phase_ns[p] / 1e3 / sum.phase_calls[p] : 0.0)
+            << std::setw(8) << std::setprecision(1) << (profiled_ns ? 100.0 * sum.phase_ns[p] / profiled_ns : 0.0);
+        // the robots' callbacks aren't timed as a scope, so their allocations land in no phase
+        if (!allocations_counted() || p == PHASE_CALLBACKS) {
+            out << std::setw(10) << "-" << std::endl;
+        } else {
+            out << std::setw(10) << sum.phase_allocations[p] << std::endl;
+        }
+    }
+    out << std::endl;
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        out << std::left << std::setw(20) << COUNTER_NAMES[c] << std::right << std::setw(12) << sum.counters[c] << std::endl;
+    }
+    out << (allocations_counted() ? "allocations are every thread's in the process, the robots' and the console's too"
+                                  : "allocations aren't counted in this program") << std::endl;
+
+    out << std::endl << std::left << std::setw(20) << "Robot" << std::right
+        << std::setw(12) << "Robot ms" << std::setw(10) << "Radar ms" << std::setw(10) << "Shots ms" << std::setw(10) << "Moves ms"
+        << std::setw(10) << "Scanned" << std::setw(8) << "Seen" << std::setw(8) << "Shots" << std::setw(8) << "Hits" << std::setw(8) << "Moves" << std::endl;
+    for (size_t i = 1; i < m_slots.size(); i++) {
+        const Slot& slot = m_slots[i];
+        out << std::left << std::setw(20) << (i - 1 < names.size() ? names[i - 1] : "") << std::right << std::setprecision(2)
+            << std::setw(12) << slot.phase_ns[PHASE_CALLBACKS] / 1e6
+            << std::setw(10) << slot.phase_ns[PHASE_RADAR] / 1e6
+            << std::setw(10) << slot.phase_ns[PHASE_SHOTS] / 1e6
+            << std::setw(10) << slot.phase_ns[PHASE_MOVES] / 1e6
+            << std::setw(10) << slot.counters[COUNT_CELLS_SCANNED]
+            << std::setw(8) << slot.counters[COUNT_RADAR_OBJECTS]
+            << std::setw(8) << slot.counters[COUNT_SHOTS]
+            << std::setw(8) << slot.counters[COUNT_HITS]
+            << std::setw(8) << slot.counters[COUNT_MOVES] << std::endl;
+    }
+    out.unsetf(std::ios::floatfield);
+    out << std::setprecision(6);
+}
+
+static std::string json_string(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            quoted += ' ';
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+void Profiler::write_json(std::ostream& out, const std::vector<std::string>& names) const {
+    // {"allocations_counted", "phases": {name: {"ns", "calls", "allocations"}}, "counters": {name: n},
+    //  "robots": [{"name", "phases", "counters"}]}
+    // the arena's own share is in the totals but not in any robot
+    Slot sum = total();
+    out << "{\n  \"allocations_counted\": " << (allocations_counted() ? "true" : "false") << ",\n  \"phases\": {";
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        out << (p ? ", " : "") << "\"" << PHASE_NAMES[p] << "\": {\"ns\": " << sum.phase_ns[p] << ", \"calls\": " << sum.phase_calls[p]
+            << ", \"allocations\": " << sum.phase_allocations[p] << "}";
+    }
+    out << "},\n  \"counters\": {";
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        out << (c ? ", " : "") << "\"" << COUNTER_NAMES[c] << "\": " << sum.counters[c];
+    }
+    out << "},\n  \"robots\": [";
+    for (size_t i = 1; i < m_slots.size(); i++) {
+        const Slot& slot = m_slots[i];
+        out << (i > 1 ? "," : "") << "\n    {\"name\": " << json_string(i - 1 < names.size() ? names[i - 1] : "") << ", \"phases\": {";
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            out << (p ? ", " : "") << "\"" << PHASE_NAMES[p] << "\": {\"ns\": " << slot.phase_ns[p] << ", \"calls\": " << slot.phase_calls[p]
+                << ", \"allocations\": " << slot.phase_allocations[p] << "}";
+        }
+        out << "}, \"counters\": {";
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            out << (c ? ", " : "") << "\"" << COUNTER_NAMES[c] << "\": " << slot.counters[c];
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+
+// where a match spends its time
+enum ProfilePhase : uint8_t {
+    PHASE_CALLBACKS,    // inside the robots' own code
+    PHASE_RADAR,
+    PHASE_SHOTS,
+    PHASE_DAMAGE,
+    PHASE_MOVES,
+    PHASE_RENDER,       // building board frames, the drawing itself happens on the console thread
+    PHASE_COUNT
+};
+
+// what a match does
+enum ProfileCounter : uint8_t {
+    COUNT_CELLS_SCANNED,    // cells covered by radar rays
+    COUNT_RADAR_OBJECTS,
+    COUNT_SHOTS,
+    COUNT_HITS,
+    COUNT_MOVES,
+    COUNT_ALLOCATIONS,      // heap allocations during the match by every thread in the process, the robots' and the console's too
+    COUNTER_COUNT
+};
+
+// where allocation counts come from. AllocationCounter.o replaces the global operator new to
+// count heap allocations and installs itself here before main; only RobotWarz and ArenaBench link
+// it. in any other program nothing is installed, operator new is the library's own and every
+// count reads 0. counting is off until count_allocations(true), and each of those keeps it on
+// until its count_allocations(false); off, it costs operator new one load.
+struct AllocationCounter {
+    void (*set_counting)(bool on);
+    long long (*process_count)();   // every thread in the process, while counting was on
+    long long (*thread_count)();    // the calling thread only, so reading it shares nothing
+};
+void install_allocation_counter(const AllocationCounter& counter);
+bool allocations_counted();
+void count_allocations(bool on);
+long long allocation_count();
+long long thread_allocation_count();
+
+// per phase timers and counters for one match. it is always compiled in and costs a
+// branch when turned off. every robot gets its own slot, and one more is for the arena
+// itself, so robots deciding side by side each write only their own and nothing is shared.
+// allocations are only counted while a profiler that is on is between start and finish:
+// each timed phase gets the allocations its own thread made while it ran (robot callbacks
+// aren't timed as a scope, so they get none), and COUNT_ALLOCATIONS is the process wide total.
+class Profiler {
+private:
+    struct Slot {
+        int64_t phase_ns[PHASE_COUNT];
+        long long phase_calls[PHASE_COUNT];
+        long long phase_allocations[PHASE_COUNT];
+        long long counters[COUNTER_COUNT];
+    };
+    bool m_enabled;
+    bool m_counting;    // allocations are being counted for this profiler, between start and finish
+    std::vector<Slot> m_slots;  // slot 0 is the arena, robot i is slot i + 1
+    long long m_start_allocations;
+    Slot total() const;
+public:
+    Profiler();
+    ~Profiler();
+    void set_enabled(bool enabled);
+    bool enabled() const { return m_enabled; }
+    // clears everything for a match with this many robots, and must come before anything is timed
+    void start(int robots);
+    // robot -1 is the arena
+    void add_time(ProfilePhase phase, int robot, int64_t ns, long long allocations = 0) {
+        Slot& slot = m_slots[robot + 1];
+        slot.phase_ns[phase] += ns;
+        slot.phase_calls[phase]++;
+        slot.phase_allocations[phase] += allocations;
+    }
+    void count(ProfileCounter counter, int robot, long long amount = 1) {
+        if (m_enabled) {
+            m_slots[robot + 1].counters[counter] += amount;
+        }
+    }
+    void finish();
+    void print_report(std::ostream& out, const std::vector<std::string>& names) const;
+    void write_json(std::ostream& out, const std::vector<std::string>& names) const;
+};
+
+// times the scope it lives in and adds it to a phase, with the allocations made on this
+// thread meanwhile, when the profiler is on
+class ScopedTimer {
+private:
+    Profiler& m_profiler;
+    ProfilePhase m_phase;
+    int m_robot;
+    bool m_on;
+    long long m_start_allocations;
+    std::chrono::steady_clock::time_point m_start;
+public:
+    ScopedTimer(Profiler& profiler, ProfilePhase phase, int robot = -1)
+        : m_profiler(profiler), m_phase(phase), m_robot(robot), m_on(profiler.enabled()), m_start_allocations(0) {
+        if (m_on) {
+            m_start_allocations = thread_allocation_count();
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedTimer() {
+        stop();
+    }
+    // ends the timing early, for a scope that goes on into a phase of its own
+    void stop() {
+        if (m_on) {
+            m_profiler.add_time(m_phase, m_robot, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count(),
+                                thread_allocation_count() - m_start_allocations);
+            m_on = false;
+        }
+    }
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+// xoshiro256** - small, fast and good enough for dice rolls. every Arena owns one,
+// so matches don't share (or lock) any global random state and a seed replays a match exactly.
+class Rng {
+private:
+    uint64_t m_state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    Rng(uint64_t seed = 0) {
+        set_seed(seed);
+    }
+
+    // spreads the seed over the whole state with splitmix64 so any seed (even 0) is fine
+    void set_seed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9e3779b97f4a7c15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            m_state[i] = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // uniform in [0, n), n > 0. multiply and shift instead of %, with no bias
+    int below(int n) {
+        uint64_t bound = static_cast<uint32_t>(n);
+        uint64_t product = (next() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = static_cast<uint32_t>(-static_cast<uint32_t>(bound)) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<int>(product >> 32);
+    }
+
+    // uniform in [low, high]
+    int range(int low, int high) {
+        return low + below(high - low + 1);
+    }
+};
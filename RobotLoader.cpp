@@ -0,0 +1,240 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <regex>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "RobotLoader.h"
+#include "ThreadPool.h"
+
+// 64 bit FNV-1a, plenty to tell builds apart
+static void hash_bytes(uint64_t& hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+}
+
+static void hash_file(uint64_t& hash, const std::string& path) {
+    // hashes the length first so moving bytes between files changes the hash
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint64_t size = contents.size();
+    hash_bytes(hash, reinterpret_cast<const char*>(&size), sizeof(size));
+    hash_bytes(hash, contents.data(), contents.size());
+}
+
+static std::string quoted_include(const std::string& line) {
+    // the file named by an #include "..." line, empty for any other line
+    size_t at = line.find_first_not_of(" \t");
+    if (at == std::string::npos || line[at] != '#') {
+        return "";
+    }
+    at = line.find_first_not_of(" \t", at + 1);
+    if (at == std::string::npos || line.compare(at, 7, "include") != 0) {
+        return "";
+    }
+    size_t open = line.find_first_not_of(" \t", at + 7);
+    if (open == std::string::npos || line[open] != '"') {
+        return "";
+    }
+    size_t close = line.find('"', open + 1);
+    if (close == std::string::npos) {
+        return "";
+    }
+    return line.substr(open + 1, close - open - 1);
+}
+
+static void hash_with_includes(uint64_t& hash, const std::string& path, std::set<std::string>& seen) {
+    // hashes the file, then every file it pulls in with #include "...", each one once
+    // a name is looked for next to the file that includes it, then in . like the compiler's -I.
+    // <...> includes are the system's and are left out, as is anything the preprocessor would skip
+    if (!seen.insert(path).second) {
+        return;
+    }
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint64_t size = contents.size();
+    hash_bytes(hash, path.data(), path.size());
+    hash_bytes(hash, reinterpret_cast<const char*>(&size), sizeof(size));
+    hash_bytes(hash, contents.data(), contents.size());
+
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    std::istringstream lines(contents);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::string name = quoted_include(line);
+        if (name.empty()) {
+            continue;
+        }
+        if (access((directory + name).c_str(), F_OK) == 0) {
+            hash_with_includes(hash, directory + name, seen);
+        } else if (access(name.c_str(), F_OK) == 0) {
+            hash_with_includes(hash, name, seen);
+        }
+    }
+}
+
+static std::string robot_name(const std::string& source) {
+    // strips the directory and the .cpp
+    std::string name = source;
+    size_t slash = name.rfind('/');
+    if (slash != std::string::npos) {
+        name = name.substr(slash + 1);
+    }
+    size_t pos = name.rfind(".cpp");
+    if (pos != std::string::npos) {
+        name = name.substr(0, pos);
+    }
+    return name;
+}
+
+static void remove_stale_builds(const std::string& name, const std::string& keep) {
+    // old builds of this robot are never used again once it has been rebuilt
+    DIR *dir;
+    struct dirent *ent;
+    std::string prefix = name + "-";
+    if ((dir = opendir(ROBOT_CACHE_DIR.c_str())) == nullptr) {
+        return;
+    }
+    while ((ent = readdir(dir)) != nullptr) {
+        std::string filename = ent->d_name;
+        std::string path = ROBOT_CACHE_DIR + "/" + filename;
+        if (filename.rfind(prefix, 0) == 0 && filename.find('-', prefix.size()) == std::string::npos && path != keep) {
+            std::remove(path.c_str());
+        }
+    }
+    closedir(dir);
+}
+
+std::vector<std::string> find_robot_sources(const std::string& directory) {
+    std::vector<std::string> sources;
+
+    std::regex pattern("Robot_.*\\.cpp");
+
+    DIR *dir;
+    struct dirent *ent;
+
+    if ((dir = opendir(directory.c_str())) != nullptr) {
+        while ((ent = readdir(dir)) != nullptr) {
+            std::string filename = ent->d_name;
+            if (std::regex_match(filename, pattern)) {
+                sources.push_back(directory == "./" ? filename : directory + "/" + filename);
+            }
+        }
+        closedir(dir);
+    } else {
+        perror("Could not open directory");
+    }
+    std::sort(sources.begin(), sources.end());
+    return sources;
+}
+
+uint64_t robot_build_hash(const std::string& source) {
+    // everything that can change the .so: flags, the robot with every header it includes,
+    // and the RobotBase it links against
+    uint64_t hash = 14695981039346656037ull;
+    hash_bytes(hash, ROBOT_COMPILE_FLAGS.data(), ROBOT_COMPILE_FLAGS.size());
+    std::set<std::string> seen;
+    hash_with_includes(hash, source, seen);
+    hash_file(hash, "RobotBase.o");
+    return hash;
+}
+
+std::vector<std::string> compile_robots(const std::vector<std::string>& sources) {
+    // each robot gets its own job on the pool
+    // cached .so files are named by build hash so a hit is just a file check
+    // new builds go to a temp file first and are renamed in, so a half written .so is never loaded
+    std::vector<std::string> shared_libs(sources.size());
+    std::mutex print_mutex;
+
+    mkdir(ROBOT_CACHE_DIR.c_str(), 0755);
+
+    ThreadPool pool;
+    pool.parallel_for(sources.size(), [&](size_t i) {
+        std::string filename = sources[i];
+        std::string name = robot_name(filename);
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(robot_build_hash(filename)));
+        std::string shared_lib = ROBOT_CACHE_DIR + "/" + name + "-" + hash + ".so";
+
+        if (access(shared_lib.c_str(), F_OK) == 0) {
+            shared_libs[i] = shared_lib;
+            return;
+        }
+
+        std::string temp_lib = shared_lib + ".tmp";
+        std::string compile_cmd = "g++ " + ROBOT_COMPILE_FLAGS + " -o " + temp_lib + " " + filename + " RobotBase.o";
+        {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cout << "Compiling " << filename << " to " << shared_lib << "...\n";
+        }
+
+        int compile_result = std::system(compile_cmd.c_str());
+        if (compile_result != 0 || std::rename(temp_lib.c_str(), shared_lib.c_str()) != 0) {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cerr << "Failed to compile " << filename << " with command: " << compile_cmd << std::endl;
+            std::remove(temp_lib.c_str());
+            return;
+        }
+        remove_stale_builds(name, shared_lib);
+        shared_libs[i] = shared_lib;
+    });
+    return shared_libs;
+}
+
+std::vector<RobotLibrary> load_robot_libraries(const std::string& directory) {
+    // compile everything first, then open each shared object and find its factory
+    std::vector<std::string> sources = find_robot_sources(directory);
+    std::vector<std::string> shared_libs = compile_robots(sources);
+    std::vector<RobotLibrary> libraries;
+
+    for (size_t i = 0; i < shared_libs.size(); i++) {
+        if (shared_libs[i].empty()) {
+            continue;
+        }
+        std::string shared_lib = "./" + shared_libs[i];
+        void* handle = dlopen(shared_lib.c_str(), RTLD_LAZY);
+        if (!handle) 
+        {
+            std::cerr << "Failed to load " << shared_lib << ": " << dlerror() << std::endl;
+            continue;
+        }
+
+        RobotFactory create_robot = (RobotFactory)dlsym(handle, "create_robot");
+        if (!create_robot) 
+        {
+            std::cerr << "Failed to find create_robot in " << shared_lib << ": " << dlerror() << std::endl;
+            dlclose(handle);
+            continue;
+        }
+
+        RobotLibrary library;
+        library.name = robot_name(sources[i]);
+        if (library.name.rfind("Robot_", 0) == 0) {
+            library.name = library.name.substr(6);
+        }
+        library.handle = handle;
+        library.create_robot = create_robot;
+        libraries.push_back(library);
+    }
+    return libraries;
+}
+
+void close_robot_libraries(std::vector<RobotLibrary>& libraries) {
+    for (size_t i = 0; i < libraries.size(); i++) {
+        dlclose(libraries[i].handle);
+    }
+    libraries.clear();
+}
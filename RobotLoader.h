@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "RobotBase.h"
+
+// where compiled robots are kept between runs
+const std::string ROBOT_CACHE_DIR = ".robot_cache";
+const std::string ROBOT_COMPILE_FLAGS = "-shared -fPIC -I. -std=c++20";
+
+// finds every Robot_*.cpp in the directory, sorted by name so the play order is stable
+std::vector<std::string> find_robot_sources(const std::string& directory);
+
+// hashes the robot source together with everything else that ends up in its .so: the
+// headers it pulls in with #include "...", followed recursively, and RobotBase.o
+uint64_t robot_build_hash(const std::string& source);
+
+// compiles the robot sources into shared objects, all at once across the cores.
+// a source is only recompiled if no cached .so exists for its build hash.
+// returns the path of the .so for each source, or an empty string if it failed to build.
+std::vector<std::string> compile_robots(const std::vector<std::string>& sources);
+
+// a loaded robot shared object. create_robot can be called as often as needed,
+// every call makes a fresh robot
+struct RobotLibrary {
+    std::string name;   // taken from the file name, without Robot_ and .cpp
+    void* handle;
+    RobotFactory create_robot;
+};
+
+// compiles and opens every robot in the directory, skipping any that fail
+std::vector<RobotLibrary> load_robot_libraries(const std::string& directory);
+
+// closes the libraries, every robot made from them must already be deleted
+void close_robot_libraries(std::vector<RobotLibrary>& libraries);
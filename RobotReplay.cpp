@@ -0,0 +1,166 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+
+#include "MatchLog.h"
+#include "BoardRenderer.h"
+
+// shows a match from its binary log without loading or running any robots.
+// RobotReplay LOG prints a summary, RobotReplay LOG ROUND draws the board as it
+// stood at the start of that round and lists everything that happened in it,
+// and RobotReplay LOG --play plays the whole match back round by round.
+
+// pause between rounds when playing a match back
+const int PLAY_ROUND_MS = 300;
+
+const char* WEAPON_NAMES[] = {"flamethrower", "railgun", "grenade", "hammer"};
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " LOG [ROUND | --play]" << std::endl;
+}
+
+void display_board(BoardRenderer& renderer, const ReplayBoard& board, const MatchLogRobot* robots, int robot_count) {
+    // the same frame as Arena::display_board, from the rebuilt board
+    for (int rw = 0; rw < board.height; rw++) {
+        for (int cl = 0; cl < board.width; cl++) {
+            int index = rw*board.width + cl;
+            char robot = ' ';
+            if (board.cells[index] == 'R' && board.cell_robot[index] >= 0 && board.cell_robot[index] < robot_count) {
+                robot = robots[board.cell_robot[index]].character;
+            }
+            renderer.set_cell(rw, cl, board.cells[index], robot);
+        }
+    }
+    renderer.draw();
+}
+
+std::string robot_name(const MatchLogHeader& header, const MatchLogRobot* robots, int robot) {
+    if (robot < 0 || robot >= header.robot_count) {
+        return "the arena";
+    }
+    // the name may fill its whole field without a terminator
+    return std::string(robots[robot].name, strnlen(robots[robot].name, sizeof(robots[robot].name)));
+}
+
+void describe_event(const MatchLogHeader& header, const MatchLogRobot* robots, const MatchEvent& event) {
+    // one line per event, worded like the live turn log
+    std::string name = robot_name(header, robots, event.robot);
+    const int* v = event.values;
+    switch (event.type) {
+        case EVENT_RADAR:
+            std::cout << "\t" << name << " at (" << v[0] << "," << v[1] << ") scans direction " << int(event.detail)
+                      << " and finds " << v[2] << std::endl;
+            break;
+        case EVENT_SHOT:
+            std::cout << "\t" << name << " fires " << (event.detail >= 0 && event.detail < 4 ? WEAPON_NAMES[int(event.detail)] : "?")
+                      << " at (" << v[0] << "," << v[1] << ")" << std::endl;
+            break;
+        case EVENT_HIT:
+            std::cout << "\t" << name << " is hit by " << robot_name(header, robots, v[0]) << " for " << v[1] << std::endl;
+            break;
+        case EVENT_DAMAGE:
+            std::cout << "\t" << name << " takes " << v[1] << ", health " << v[2] << " armor " << v[3] << std::endl;
+            break;
+        case EVENT_MOVE:
+            std::cout << "\t" << name << " moves from (" << v[0] << "," << v[1] << ") to (" << v[2] << "," << v[3] << ")" << std::endl;
+            break;
+        case EVENT_DEATH:
+            std::cout << "\t" << name << " is out at (" << v[0] << "," << v[1] << ")" << std::endl;
+            break;
+        case EVENT_END:
+            std::cout << "End of game after " << v[1] << " rounds, winner " << (v[0] >= 0 ? robot_name(header, robots, v[0]) : "none") << std::endl;
+            break;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    MatchLogView log;
+    if (!log.open(argv[1])) {
+        return 1;
+    }
+    const MatchLogHeader& header = log.header();
+    const MatchLogRobot* robots = log.robots();
+    const MatchEvent* events = log.events();
+    size_t count = log.event_count();
+
+    // one pass over the records finds where every round starts
+    std::vector<size_t> round_starts;
+    for (size_t e = 0; e < count; e++) {
+        if (events[e].type == EVENT_ROUND) {
+            round_starts.push_back(e);
+        }
+    }
+
+    if (argc == 2) {
+        std::cout << header.height << "x" << header.width << " arena, seed " << header.seed
+                  << ", " << round_starts.size() << " rounds, " << count << " events" << std::endl;
+        ReplayBoard board;
+        reset_replay(board, header);
+        for (size_t e = 0; e < count; e++) {
+            apply_event(board, events[e]);
+        }
+        for (int r = 0; r < header.robot_count; r++) {
+            std::cout << robots[r].character << " " << robot_name(header, robots, r) << " ("
+                      << (robots[r].weapon >= 0 && robots[r].weapon < 4 ? WEAPON_NAMES[int(robots[r].weapon)] : "?") << ")"
+                      << " dealt " << board.damage_dealt[r] << " took " << board.damage_taken[r] << std::endl;
+        }
+        if (count > 0) {
+            describe_event(header, robots, events[count - 1]);
+        }
+        return 0;
+    }
+
+    // the board starts empty and is rebuilt from the events
+    ReplayBoard board;
+    reset_replay(board, header);
+    BoardRenderer renderer;
+
+    if (std::string(argv[2]) == "--play") {
+        // every round is drawn over the last one on a terminal, so only the changes are written
+        renderer.reset(board.height, board.width, isatty(STDOUT_FILENO));
+        size_t e = 0;
+        for (size_t r = 0; r < round_starts.size(); r++) {
+            for (; e < round_starts[r]; e++) {
+                apply_event(board, events[e]);
+            }
+            std::cout << "         =========== starting round " << r + 1 << " ===========";
+            display_board(renderer, board, robots, header.robot_count);
+            size_t end = r + 1 < round_starts.size() ? round_starts[r + 1] : count;
+            for (size_t n = e + 1; n < end; n++) {
+                describe_event(header, robots, events[n]);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(PLAY_ROUND_MS));
+        }
+        renderer.finish();
+        return 0;
+    }
+
+    int round = std::atoi(argv[2]);
+    if (round < 1 || round > static_cast<int>(round_starts.size())) {
+        std::cerr << "Round " << argv[2] << " is not in this log, it has rounds 1 to " << round_starts.size() << std::endl;
+        return 1;
+    }
+
+    // replay the board up to the start of the round, then narrate the round itself
+    size_t start = round_starts[round - 1];
+    size_t end = round < static_cast<int>(round_starts.size()) ? round_starts[round] : count;
+    for (size_t e = 0; e < start; e++) {
+        apply_event(board, events[e]);
+    }
+    renderer.reset(board.height, board.width, false);
+    std::cout << "         =========== starting round " << round << " ===========";
+    display_board(renderer, board, robots, header.robot_count);
+    for (size_t e = start + 1; e < end; e++) {
+        describe_event(header, robots, events[e]);
+    }
+    return 0;
+}
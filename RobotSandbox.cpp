@@ -0,0 +1,332 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <new>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "RobotSandbox.h"
+
+// how often a waiting side checks the shared word before it sleeps in the kernel.
+// a robot normally answers in a few microseconds, so most calls never sleep
+const int SANDBOX_SPIN_LIMIT = 4000;
+
+// the longest the arena sleeps at a time while it waits, so a worker that died is noticed quickly
+const int SANDBOX_SLICE_US = 1000;
+
+// a new worker also has to build its robot before it says hello
+const int SANDBOX_STARTUP_MS = 1000;
+
+typedef std::chrono::steady_clock::time_point Deadline;
+
+static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// the channel lives in memory shared between two processes, so these are the plain
+// (not PRIVATE) futex calls. the word is compared by the kernel, so a change that
+// lands between our check and the sleep just makes the wait return straight away
+static void futex_wait(std::atomic<uint32_t>& word, uint32_t value, int timeout_us) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_us / 1000000;
+    timeout.tv_nsec = (timeout_us % 1000000) * 1000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, value, timeout_us >= 0 ? &timeout : nullptr, nullptr, 0);
+}
+
+static void futex_wake(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+static bool worker_gone(pid_t pid) {
+    // WNOWAIT leaves the worker to be reaped by kill_worker, so its pid can't be reused before then
+    siginfo_t info;
+    info.si_pid = 0;
+    return waitid(P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == pid;
+}
+
+static bool wait_for_change(std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiters, uint32_t value, const Deadline* deadline, pid_t peer) {
+    // spins for a while, then sleeps on the futex until the word moves off value
+    // the arena passes a deadline and the worker's pid and gets false if either runs out
+    // the worker passes neither and waits for as long as it takes
+    for (int spin = 0; spin < SANDBOX_SPIN_LIMIT; spin++) {
+        if (word.load(std::memory_order_acquire) != value) {
+            return true;
+        }
+        cpu_relax();
+    }
+    while (true) {
+        int timeout_us = -1;
+        if (deadline) {
+            long long left = std::chrono::duration_cast<std::chrono::microseconds>(*deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) {
+                return word.load(std::memory_order_acquire) != value;
+            }
+            timeout_us = std::min<long long>(left, SANDBOX_SLICE_US);
+        }
+        waiters.fetch_add(1);
+        if (word.load() == value) {
+            futex_wait(word, value, timeout_us);
+        }
+        waiters.fetch_sub(1);
+        if (word.load(std::memory_order_acquire) != value) {
+            return true;
+        }
+        if (peer > 0 && worker_gone(peer)) {
+            return false;
+        }
+    }
+}
+
+static bool ring_write(SandboxRing& ring, const void* data, size_t size, const Deadline* deadline, pid_t peer) {
+    // copies as much as fits, publishes it, and waits for room if there is more
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        uint32_t head = ring.head.load(std::memory_order_relaxed);
+        uint32_t tail = ring.tail.load(std::memory_order_acquire);
+        uint32_t space = SANDBOX_RING_BYTES - (head - tail);
+        if (space == 0) {
+            if (!wait_for_change(ring.tail, ring.tail_waiters, tail, deadline, peer)) {
+                return false;
+            }
+            continue;
+        }
+        uint32_t offset = head % SANDBOX_RING_BYTES;
+        uint32_t chunk = std::min<size_t>({size, space, SANDBOX_RING_BYTES - offset});
+        std::memcpy(ring.data + offset, bytes, chunk);
+        ring.head.store(head + chunk);
+        if (ring.head_waiters.load()) {
+            futex_wake(ring.head);
+        }
+        bytes += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static bool ring_read(SandboxRing& ring, void* data, size_t size, const Deadline* deadline, pid_t peer) {
+    // the mirror of ring_write: waits for bytes, copies them out and hands the room back
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+        if (head == tail) {
+            if (!wait_for_change(ring.head, ring.head_waiters, head, deadline, peer)) {
+                return false;
+            }
+            continue;
+        }
+        uint32_t offset = tail % SANDBOX_RING_BYTES;
+        uint32_t chunk = std::min<size_t>({size, head - tail, SANDBOX_RING_BYTES - offset});
+        std::memcpy(bytes, ring.data + offset, chunk);
+        ring.tail.store(tail + chunk);
+        if (ring.tail_waiters.load()) {
+            futex_wake(ring.tail);
+        }
+        bytes += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static void apply_state(RobotBase* robot, const SandboxState& state) {
+    // the worker's robot only ever loses health, armor, movement and grenades,
+    // so the same mutators the arena used bring it level again
+    robot->set_boundaries(state.row_max, state.col_max);
+    robot->move_to(state.row, state.col);
+    if (robot->get_health() > state.health) {
+        robot->take_damage(robot->get_health() - state.health);
+    }
+    if (robot->get_armor() > state.armor) {
+        robot->reduce_armor(robot->get_armor() - state.armor);
+    }
+    if (state.move == 0 && robot->get_move_speed() > 0) {
+        robot->disable_movement();
+    }
+    while (robot->get_grenades() > state.grenades) {
+        robot->decrement_grenades();
+    }
+}
+
+static void serve_robot(SandboxChannel* channel, RobotFactory create_robot) {
+    // runs in the worker: builds the robot, says hello, then answers requests until killed
+    RobotBase* robot = create_robot();
+    if (!robot) {
+        return;
+    }
+    SandboxHello hello;
+    std::memset(&hello, 0, sizeof(hello));
+    hello.move = robot->get_move_speed();
+    hello.armor = robot->get_armor();
+    hello.weapon = robot->get_weapon();
+    std::strncpy(hello.name, robot->m_name.c_str(), sizeof(hello.name) - 1);
+    ring_write(channel->replies, &hello, sizeof(hello), nullptr, 0);
+
+    std::vector<SandboxRadarRecord> records;
+    std::vector<RadarObj> radar_results;
+    while (true) {
+        SandboxRequest request;
+        ring_read(channel->requests, &request, sizeof(request), nullptr, 0);
+        apply_state(robot, request.state);
+        SandboxReply reply;
+        std::memset(&reply, 0, sizeof(reply));
+        switch (request.op) {
+            case SANDBOX_RADAR_DIRECTION:
+                robot->get_radar_direction(reply.values[0]);
+                break;
+            case SANDBOX_RADAR_RESULTS:
+                records.resize(request.count);
+                ring_read(channel->requests, records.data(), records.size() * sizeof(SandboxRadarRecord), nullptr, 0);
+                radar_results.clear();
+                for (size_t i = 0; i < records.size(); i++) {
+                    radar_results.push_back(RadarObj {static_cast<char>(records[i].type), records[i].row, records[i].col});
+                }
+                robot->process_radar_results(radar_results);
+                break;
+            case SANDBOX_SHOT_LOCATION:
+                reply.values[0] = robot->get_shot_location(reply.values[1], reply.values[2]);
+                break;
+            case SANDBOX_MOVE_DIRECTION:
+                robot->get_move_direction(reply.values[0], reply.values[1]);
+                break;
+        }
+        ring_write(channel->replies, &reply, sizeof(reply), nullptr, 0);
+    }
+}
+
+SandboxedRobot::SandboxedRobot(int move, int armor, WeaponType weapon, pid_t pid, SandboxChannel* channel, int deadline_ms)
+    : RobotBase(move, armor, weapon), m_pid(pid), m_channel(channel), m_deadline_ms(deadline_ms), m_crashed(false) {}
+
+SandboxedRobot* SandboxedRobot::spawn(RobotFactory create_robot, int deadline_ms) {
+    // maps the channel, forks, and waits for the worker's hello to build the proxy from
+    void* memory = mmap(nullptr, sizeof(SandboxChannel), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Could not map a sandbox channel" << std::endl;
+        return nullptr;
+    }
+    SandboxChannel* channel = new (memory) SandboxChannel();
+    std::cout.flush();
+    pid_t arena_pid = getpid();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "Could not fork a sandbox worker" << std::endl;
+        munmap(memory, sizeof(SandboxChannel));
+        return nullptr;
+    }
+    if (pid == 0) {
+        // the worker goes down with the arena, and never runs the arena's exit code
+        // if the arena died before the death signal was asked for, it will never come, so leave now
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        if (getppid() != arena_pid) {
+            _exit(1);
+        }
+        serve_robot(channel, create_robot);
+        _exit(0);
+    }
+
+    SandboxHello hello;
+    Deadline deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SANDBOX_STARTUP_MS + deadline_ms);
+    if (!ring_read(channel->replies, &hello, sizeof(hello), &deadline, pid)) {
+        std::cerr << "Sandbox worker " << pid << " never started its robot" << std::endl;
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        munmap(memory, sizeof(SandboxChannel));
+        return nullptr;
+    }
+    SandboxedRobot* robot = new SandboxedRobot(hello.move, hello.armor, static_cast<WeaponType>(hello.weapon), pid, channel, deadline_ms);
+    hello.name[sizeof(hello.name) - 1] = '\0';
+    robot->m_name = hello.name;
+    return robot;
+}
+
+SandboxedRobot::~SandboxedRobot() {
+    kill_worker();
+    munmap(m_channel, sizeof(SandboxChannel));
+}
+
+void SandboxedRobot::kill_worker() {
+    if (m_pid > 0) {
+        kill(m_pid, SIGKILL);
+        waitpid(m_pid, nullptr, 0);
+        m_pid = -1;
+    }
+}
+
+bool SandboxedRobot::crashed() {
+    return m_crashed;
+}
+
+void SandboxedRobot::set_deadline(int deadline_ms) {
+    m_deadline_ms = deadline_ms;
+}
+
+bool SandboxedRobot::call(SandboxOp op, const std::vector<RadarObj>* radar_results, SandboxReply& reply) {
+    // sends the request with this robot's current state and waits for the reply
+    // a worker that dies or runs past the deadline is killed and the robot stays crashed
+    std::memset(&reply, 0, sizeof(reply));
+    if (m_crashed) {
+        return false;
+    }
+    SandboxRequest request;
+    request.op = op;
+    request.count = radar_results ? radar_results->size() : 0;
+    get_current_location(request.state.row, request.state.col);
+    request.state.health = get_health();
+    request.state.armor = get_armor();
+    request.state.move = get_move_speed();
+    request.state.grenades = get_grenades();
+    request.state.row_max = m_board_row_max;
+    request.state.col_max = m_board_col_max;
+    m_records.clear();
+    for (size_t i = 0; i < request.count; i++) {
+        const RadarObj& object = (*radar_results)[i];
+        m_records.push_back(SandboxRadarRecord {object.m_row, object.m_col, object.m_type});
+    }
+
+    Deadline deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_deadline_ms);
+    if (ring_write(m_channel->requests, &request, sizeof(request), &deadline, m_pid)
+        && ring_write(m_channel->requests, m_records.data(), m_records.size() * sizeof(SandboxRadarRecord), &deadline, m_pid)
+        && ring_read(m_channel->replies, &reply, sizeof(reply), &deadline, m_pid)) {
+        return true;
+    }
+    std::cerr << m_name << " crashed or ran out of time, its worker was stopped" << std::endl;
+    kill_worker();
+    m_crashed = true;
+    std::memset(&reply, 0, sizeof(reply));
+    return false;
+}
+
+void SandboxedRobot::get_radar_direction(int& radar_direction) {
+    SandboxReply reply;
+    call(SANDBOX_RADAR_DIRECTION, nullptr, reply);
+    radar_direction = reply.values[0];
+}
+
+void SandboxedRobot::process_radar_results(const std::vector<RadarObj>& radar_results) {
+    SandboxReply reply;
+    call(SANDBOX_RADAR_RESULTS, &radar_results, reply);
+}
+
+bool SandboxedRobot::get_shot_location(int& shot_row, int& shot_col) {
+    SandboxReply reply;
+    call(SANDBOX_SHOT_LOCATION, nullptr, reply);
+    shot_row = reply.values[1];
+    shot_col = reply.values[2];
+    return reply.values[0] != 0;
+}
+
+void SandboxedRobot::get_move_direction(int& direction, int& distance) {
+    SandboxReply reply;
+    call(SANDBOX_MOVE_DIRECTION, nullptr, reply);
+    direction = reply.values[0];
+    distance = reply.values[1];
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "RobotBase.h"
+
+// bytes in each direction of a sandbox channel, a power of two
+const uint32_t SANDBOX_RING_BYTES = 1 << 16;
+
+// how long a sandboxed robot gets to answer a call, unless the arena says otherwise
+const int SANDBOX_DEADLINE_MS = 100;
+
+// a one way byte stream in shared memory between the arena and a robot process.
+// head and tail only ever count up, the position in data is the count modulo the size.
+// the waiter counts tell the other side whether it has to make a futex wake call.
+struct SandboxRing {
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> head_waiters;
+    std::atomic<uint32_t> tail_waiters;
+    char data[SANDBOX_RING_BYTES];
+};
+
+struct SandboxChannel {
+    SandboxRing requests;   // arena to robot
+    SandboxRing replies;    // robot to arena
+};
+
+// the fixed binary messages that go through the rings
+enum SandboxOp : uint32_t { SANDBOX_RADAR_DIRECTION = 1, SANDBOX_RADAR_RESULTS, SANDBOX_SHOT_LOCATION, SANDBOX_MOVE_DIRECTION };
+
+// what the arena has done to the robot since its last call, so the copy in the worker matches
+struct SandboxState {
+    int32_t row;
+    int32_t col;
+    int32_t health;
+    int32_t armor;
+    int32_t move;
+    int32_t grenades;
+    int32_t row_max;
+    int32_t col_max;
+};
+
+// a request is followed by count radar records
+struct SandboxRequest {
+    uint32_t op;
+    uint32_t count;
+    SandboxState state;
+};
+
+struct SandboxRadarRecord {
+    int32_t row;
+    int32_t col;
+    int32_t type;
+};
+
+// radar direction / shot taken, row, col / direction, distance
+struct SandboxReply {
+    int32_t values[3];
+};
+
+// the first thing a new worker sends back: what the robot was built with
+struct SandboxHello {
+    int32_t move;
+    int32_t armor;
+    int32_t weapon;
+    char name[64];
+};
+
+// stands in for a robot that lives in its own forked process. the arena treats it like
+// any other robot; the four callbacks are sent to the worker over the shared memory
+// channel and the answers come back the same way. if the worker crashes or misses its
+// deadline it is killed and every call after that does nothing.
+class SandboxedRobot : public RobotBase {
+private:
+    pid_t m_pid;
+    SandboxChannel* m_channel;
+    int m_deadline_ms;
+    bool m_crashed;
+    std::vector<SandboxRadarRecord> m_records;
+    SandboxedRobot(int move, int armor, WeaponType weapon, pid_t pid, SandboxChannel* channel, int deadline_ms);
+    bool call(SandboxOp op, const std::vector<RadarObj>* radar_results, SandboxReply& reply);
+    void kill_worker();
+public:
+    // forks a worker that makes its robot with create_robot, nullptr if it never answers
+    static SandboxedRobot* spawn(RobotFactory create_robot, int deadline_ms);
+    virtual ~SandboxedRobot();
+    bool crashed();
+    void set_deadline(int deadline_ms);
+
+    virtual void get_radar_direction(int& radar_direction) override;
+    virtual void process_radar_results(const std::vector<RadarObj>& radar_results) override;
+    virtual bool get_shot_location(int& shot_row, int& shot_col) override;
+    virtual void get_move_direction(int& direction, int& distance) override;
+};
@@ -0,0 +1,73 @@
+#include <vector>
+#include <algorithm>
+
+#include "RobotTable.h"
+
+void RobotTable::clear() {
+    m_robots.clear();
+    m_row.clear();
+    m_col.clear();
+    m_health.clear();
+    m_armor.clear();
+    m_move.clear();
+    m_grenades.clear();
+    m_weapon.clear();
+    m_alive.clear();
+}
+
+void RobotTable::add(RobotBase* robot) {
+    m_robots.push_back(nullptr);
+    m_row.push_back(0);
+    m_col.push_back(0);
+    m_health.push_back(0);
+    m_armor.push_back(0);
+    m_move.push_back(0);
+    m_grenades.push_back(0);
+    m_weapon.push_back(0);
+    m_alive.push_back(0);
+    reload(m_robots.size() - 1, robot);
+}
+
+void RobotTable::reload(int robot, RobotBase* base) {
+    m_robots[robot] = base;
+    base->get_current_location(m_row[robot], m_col[robot]);
+    m_health[robot] = base->get_health();
+    m_armor[robot] = base->get_armor();
+    m_move[robot] = base->get_move_speed();
+    m_grenades[robot] = base->get_grenades();
+    m_weapon[robot] = base->get_weapon();
+    m_alive[robot] = m_health[robot] > 0;
+}
+
+void RobotTable::move_to(int robot, int row, int col) {
+    m_row[robot] = row;
+    m_col[robot] = col;
+    m_robots[robot]->move_to(row, col);
+}
+
+void RobotTable::damage(int robot, int health_lost, int armor_lost) {
+    // clamped the same way RobotBase clamps them
+    m_health[robot] = std::max(m_health[robot] - health_lost, 0);
+    m_armor[robot] = std::max(m_armor[robot] - armor_lost, 0);
+    m_alive[robot] = m_health[robot] > 0;
+    m_robots[robot]->take_damage(health_lost);
+    m_robots[robot]->reduce_armor(armor_lost);
+}
+
+void RobotTable::knock_out(int robot) {
+    m_robots[robot]->take_damage(m_health[robot]);
+    m_robots[robot]->disable_movement();
+    m_health[robot] = 0;
+    m_move[robot] = 0;
+    m_alive[robot] = 0;
+}
+
+void RobotTable::disable_movement(int robot) {
+    m_move[robot] = 0;
+    m_robots[robot]->disable_movement();
+}
+
+void RobotTable::use_grenade(int robot) {
+    m_grenades[robot] = std::max(m_grenades[robot] - 1, 0);
+    m_robots[robot]->decrement_grenades();
+}
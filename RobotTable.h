@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "RobotBase.h"
+
+// the arena's own record of every robot's state, one array per field, indexed like
+// Arena::m_robots_list. the arena reads robots from here and changes them only through
+// here; each change is passed on to the RobotBase through its final mutators so the
+// robot's own code still sees where it is and how it's doing. loops over every robot
+// then walk a few small arrays instead of calling through scattered heap pointers.
+// the reads are defined here so those loops inline them.
+class RobotTable {
+private:
+    std::vector<RobotBase*> m_robots;
+    std::vector<int> m_row;
+    std::vector<int> m_col;
+    std::vector<int> m_health;
+    std::vector<int> m_armor;
+    std::vector<int> m_move;
+    std::vector<int> m_grenades;
+    std::vector<uint8_t> m_weapon;  // WeaponType
+    std::vector<uint8_t> m_alive;   // health left
+public:
+    void clear();
+    void add(RobotBase* robot);
+    // reads the robot's state back in, for when it was changed or replaced from outside
+    void reload(int robot, RobotBase* base);
+    int size() const { return m_robots.size(); }
+    int row(int robot) const { return m_row[robot]; }
+    int col(int robot) const { return m_col[robot]; }
+    int health(int robot) const { return m_health[robot]; }
+    int armor(int robot) const { return m_armor[robot]; }
+    int move(int robot) const { return m_move[robot]; }
+    int grenades(int robot) const { return m_grenades[robot]; }
+    WeaponType weapon(int robot) const { return static_cast<WeaponType>(m_weapon[robot]); }
+    bool alive(int robot) const { return m_alive[robot]; }
+    void move_to(int robot, int row, int col);
+    // health and armor lost in one go, the armor never goes below 0
+    void damage(int robot, int health_lost, int armor_lost);
+    // no health and no movement left
+    void knock_out(int robot);
+    void disable_movement(int robot);
+    void use_grenade(int robot);
+};
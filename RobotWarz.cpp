@@ -5,10 +5,138 @@
 #include <dirent.h>
 #include <regex>
 #include <dlfcn.h>
+#include <cstdlib>
+#include <unistd.h>
 
 #include "Arena.h"
+#include "ArenaConfig.h"
+#include "Tournament.h"
 
-int main() {
-    Arena arena = Arena();
-    return arena.game_loop();
-}
\ No newline at end of file
+// read when no config file is named on the command line
+const std::string DEFAULT_CONFIG = "RobotWarz.cfg";
+
+// headless matches have nobody watching, so make sure they end
+const int HEADLESS_MAX_ROUNDS = 1000;
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [config file] [--headless] [--sandbox] [--simultaneous] [--profile] [--profile-json FILE] [--seed N] [--log FILE] [--verbosity 0-3] [--tournament MATCHES] [--threads N]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // RobotWarz [config] plays one match with the settings from the config file
+    // --headless, --sandbox, --simultaneous, --seed, --log and --verbosity override the file for this run
+    // --profile reports where the match spent its time, --profile-json writes that report to a file as well
+    // --tournament plays many matches in parallel and ranks the robots
+    std::string config_path;
+    bool headless = false;
+    bool sandbox = false;
+    bool simultaneous = false;
+    bool profile = false;
+    std::string profile_json;
+    bool has_seed = false;
+    uint64_t seed = 0;
+    std::string log_file;
+    int verbosity = -1;
+    int matches = 0;
+    size_t threads = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--sandbox") {
+            sandbox = true;
+        } else if (arg == "--simultaneous") {
+            simultaneous = true;
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--profile-json" && i + 1 < argc) {
+            profile_json = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!parse_seed(argv[++i], seed)) {
+                std::cerr << "--seed needs a whole number from 0 to " << UINT64_MAX << ", not " << argv[i] << std::endl;
+                return 1;
+            }
+            has_seed = true;
+        } else if (arg == "--log" && i + 1 < argc) {
+            log_file = argv[++i];
+        } else if (arg == "--verbosity" && i + 1 < argc) {
+            verbosity = std::atoi(argv[++i]);
+        } else if (arg == "--tournament" && i + 1 < argc) {
+            matches = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg[0] != '-' && config_path.empty()) {
+            config_path = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // the default config file is optional, a named one is not
+    ArenaConfig config = default_config();
+    if (config_path.empty() && access(DEFAULT_CONFIG.c_str(), F_OK) == 0) {
+        config_path = DEFAULT_CONFIG;
+    }
+    if (!config_path.empty() && !load_config(config_path, config)) {
+        return 1;
+    }
+    if (headless || matches > 0) {
+        config.watch_live = false;
+    }
+    if (sandbox) {
+        config.sandbox = true;
+    }
+    if (simultaneous) {
+        config.simultaneous = true;
+    }
+    if (profile) {
+        config.profile = true;
+    }
+    if (!profile_json.empty()) {
+        config.profile_json = profile_json;
+    }
+    if (!log_file.empty()) {
+        config.log_file = log_file;
+    }
+    if (verbosity >= 0) {
+        config.verbosity = verbosity;
+    }
+    if (has_seed) {
+        config.has_seed = true;
+        config.seed = seed;
+    }
+    if (!config.watch_live && config.max_rounds == 0) {
+        config.max_rounds = HEADLESS_MAX_ROUNDS;
+    }
+
+    if (matches > 0) {
+        Tournament tournament(config, threads);
+        if (!tournament.load_robots()) {
+            return 1;
+        }
+        tournament.run(matches);
+        tournament.print_standings();
+        return 0;
+    }
+
+    Arena arena = Arena(config);
+    if (config.watch_live) {
+        return arena.game_loop();
+    }
+
+    // play one match quietly and print the result at the end
+    arena.load_robots();
+    MatchResult result = arena.play_match();
+    std::cout << "Winner: " << (result.winner >= 0 ? result.winner_name : "none") << " after " << result.rounds << " rounds, seed " << result.seed << std::endl;
+    for (size_t i = 0; i < result.robots.size(); i++) {
+        std::cout << result.robots[i].name << ": dealt " << result.robots[i].damage_dealt
+                  << " took " << result.robots[i].damage_taken
+                  << (result.robots[i].alive ? "" : " (out)") << std::endl;
+    }
+    arena.print_latencies();
+    if (config.profile || !config.profile_json.empty()) {
+        arena.print_profile();
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threads)
+    : m_job(nullptr), m_job_count(0), m_next_job(0), m_active_workers(0), m_generation(0), m_stopping(false) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    // the caller is one of the threads, so only start the rest
+    for (size_t i = 1; i < threads; i++) {
+        m_workers.emplace_back(&ThreadPool::worker, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_work_ready.notify_all();
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        m_workers[i].join();
+    }
+}
+
+size_t ThreadPool::size() {
+    return m_workers.size() + 1;
+}
+
+void ThreadPool::run_jobs() {
+    // claim job indexes until they run out
+    size_t i;
+    while ((i = m_next_job.fetch_add(1)) < m_job_count) {
+        (*m_job)(i);
+    }
+}
+
+void ThreadPool::worker() {
+    // sleep until a new generation of work is posted, help with it, then check back in
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_ready.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_generation;
+        }
+        run_jobs();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active_workers--;
+            if (m_active_workers == 0) {
+                m_work_done.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)>& job) {
+    // runs job(0) .. job(count - 1) across the pool and returns once all of them finished
+    if (count == 0) {
+        return;
+    }
+    if (m_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_job_count = count;
+        m_next_job = 0;
+        m_active_workers = m_workers.size();
+        m_generation++;
+    }
+    m_work_ready.notify_all();
+    run_jobs();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_work_done.wait(lock, [&] { return m_active_workers == 0; });
+    m_job = nullptr;
+}
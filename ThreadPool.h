@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+
+// a fixed set of worker threads that runs one parallel_for at a time.
+// the calling thread works on the jobs too, so a pool of size 1 just runs them inline.
+class ThreadPool {
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_work_ready;
+    std::condition_variable m_work_done;
+    const std::function<void(size_t)>* m_job;
+    size_t m_job_count;
+    std::atomic<size_t> m_next_job;
+    size_t m_active_workers;
+    unsigned m_generation;
+    bool m_stopping;
+    void worker();
+    void run_jobs();
+public:
+    ThreadPool(size_t threads = 0);    // 0 means one thread per core
+    virtual ~ThreadPool();
+    size_t size();
+    void parallel_for(size_t count, const std::function<void(size_t)>& job);
+};
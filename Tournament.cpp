@@ -0,0 +1,162 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "Tournament.h"
+#include "ThreadPool.h"
+
+Tournament::Tournament(const ArenaConfig& config, size_t threads) : m_config(config), m_threads(threads) {
+    m_config.watch_live = false;
+    // matches run side by side, so they can't all write the one log file
+    m_config.log_file = "";
+    // nor one profile, and a profile per match would be lost among hundreds of them
+    m_config.profile = false;
+    m_config.profile_json = "";
+    // the matches already keep every core busy, so robots in a simultaneous round take turns deciding
+    m_config.decision_threads = 1;
+    if (config.has_seed) {
+        m_seed = config.seed;
+    } else {
+        std::random_device device;
+        m_seed = (static_cast<uint64_t>(device()) << 32) | device();
+    }
+}
+
+Tournament::~Tournament() {
+    close_robot_libraries(m_libraries);
+}
+
+void Tournament::set_seed(uint64_t seed) {
+    m_seed = seed;
+}
+
+uint64_t Tournament::get_seed() {
+    return m_seed;
+}
+
+bool Tournament::load_robots() {
+    // a match needs at least two robots
+    m_libraries = load_robot_libraries("./");
+    if (m_libraries.size() < 2) {
+        std::cerr << "Need at least two robots for a tournament, found " << m_libraries.size() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Tournament::run(int matches) {
+    // every match is one job on the pool, the workers pull the next match as they finish
+    // each job builds its own headless arena and robots and writes only its own result slot
+    m_results.assign(matches, MatchResult());
+    ThreadPool pool(m_threads);
+    pool.parallel_for(matches, [&](size_t match) {
+        Arena arena(m_config);
+        arena.set_seed(m_seed + match);
+        std::vector<size_t> lineup;
+        for (size_t i = 0; i < m_libraries.size(); i++) {
+            if (arena.add_robot_from(m_libraries[i])) {
+                lineup.push_back(i);
+            }
+        }
+        m_results[match] = arena.play_match();
+        // robots may name themselves, the standings go by library
+        for (size_t r = 0; r < lineup.size(); r++) {
+            m_results[match].robots[r].name = m_libraries[lineup[r]].name;
+        }
+    });
+}
+
+std::vector<TournamentStanding> Tournament::standings() {
+    // totals are summed by library name so a robot that failed to start in one match can't shift the rest
+    // ratings are updated in match order so they don't depend on which worker finished first
+    // every match is scored as a win for the winner against each other robot, or a draw for all if nobody won
+    std::vector<TournamentStanding> table;
+    for (size_t i = 0; i < m_libraries.size(); i++) {
+        TournamentStanding standing;
+        standing.name = m_libraries[i].name;
+        standing.matches = 0;
+        standing.wins = 0;
+        standing.win_rate = 0.0;
+        standing.rating = ELO_START;
+        standing.damage_dealt = 0;
+        standing.damage_taken = 0;
+        table.push_back(standing);
+    }
+
+    std::vector<int> players;
+    std::vector<double> change;
+    for (size_t m = 0; m < m_results.size(); m++) {
+        const MatchResult& result = m_results[m];
+        players.clear();
+        int winner = -1;
+        for (size_t r = 0; r < result.robots.size(); r++) {
+            for (size_t t = 0; t < table.size(); t++) {
+                if (table[t].name == result.robots[r].name) {
+                    players.push_back(t);
+                    table[t].matches++;
+                    table[t].damage_dealt += result.robots[r].damage_dealt;
+                    table[t].damage_taken += result.robots[r].damage_taken;
+                    if ((int)r == result.winner) {
+                        table[t].wins++;
+                        winner = players.size() - 1;
+                    }
+                    break;
+                }
+            }
+        }
+
+        change.assign(players.size(), 0.0);
+        for (size_t a = 0; a < players.size(); a++) {
+            for (size_t b = 0; b < players.size(); b++) {
+                if (a == b) {
+                    continue;
+                }
+                double expected = 1.0 / (1.0 + std::pow(10.0, (table[players[b]].rating - table[players[a]].rating) / 400.0));
+                double score = 0.5;
+                if (winner >= 0) {
+                    score = ((int)a == winner) ? 1.0 : ((int)b == winner ? 0.0 : 0.5);
+                }
+                change[a] += ELO_K * (score - expected);
+            }
+        }
+        for (size_t a = 0; a < players.size(); a++) {
+            table[players[a]].rating += change[a];
+        }
+    }
+
+    for (size_t t = 0; t < table.size(); t++) {
+        if (table[t].matches > 0) {
+            table[t].win_rate = (double)table[t].wins / table[t].matches;
+        }
+    }
+    std::sort(table.begin(), table.end(), [](const TournamentStanding& a, const TournamentStanding& b) {
+        return a.rating > b.rating;
+    });
+    return table;
+}
+
+void Tournament::print_standings() {
+    std::vector<TournamentStanding> table = standings();
+    int draws = 0;
+    for (size_t m = 0; m < m_results.size(); m++) {
+        if (m_results[m].winner < 0) {
+            draws++;
+        }
+    }
+    std::cout << "Tournament of " << m_results.size() << " matches (" << draws << " without a winner), seed " << m_seed << std::endl;
+    std::cout << std::left << std::setw(20) << "Robot" << std::right
+              << std::setw(8) << "Wins" << std::setw(10) << "Win %" << std::setw(10) << "Rating"
+              << std::setw(12) << "Dealt" << std::setw(12) << "Taken" << std::endl;
+    for (size_t t = 0; t < table.size(); t++) {
+        std::cout << std::left << std::setw(20) << table[t].name << std::right
+                  << std::setw(8) << table[t].wins
+                  << std::setw(10) << std::fixed << std::setprecision(1) << table[t].win_rate * 100.0
+                  << std::setw(10) << std::fixed << std::setprecision(0) << table[t].rating
+                  << std::setw(12) << table[t].damage_dealt
+                  << std::setw(12) << table[t].damage_taken << std::endl;
+    }
+}
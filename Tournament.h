@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+#include "RobotLoader.h"
+
+// starting and K values for the Elo style rating
+const double ELO_START = 1500.0;
+const double ELO_K = 16.0;
+
+// one robot's totals across the whole tournament
+struct TournamentStanding {
+    std::string name;
+    int matches;
+    int wins;
+    double win_rate;
+    double rating;
+    long damage_dealt;
+    long damage_taken;
+};
+
+// plays many independent headless matches between the same robots.
+// every robot library is loaded once and each match gets its own Arena
+// and a fresh robot from every factory, so matches share nothing and
+// can be spread over all the cores.
+class Tournament {
+private:
+    std::vector<RobotLibrary> m_libraries;
+    ArenaConfig m_config;   // every match is played with this, headless
+    size_t m_threads;
+    uint64_t m_seed;    // match i is played with seed m_seed + i
+    std::vector<MatchResult> m_results;
+public:
+    Tournament(const ArenaConfig& config, size_t threads);
+    virtual ~Tournament();
+    void set_seed(uint64_t seed);
+    uint64_t get_seed();
+    bool load_robots();
+    void run(int matches);
+    std::vector<TournamentStanding> standings();
+    void print_standings();
+};
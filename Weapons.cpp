@@ -0,0 +1,149 @@
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include "Weapons.h"
+
+// the cells a flame covers relative to the robot, for each entry in directions[].
+// it is shaped like a radar ray cut off after FLAME_LENGTH steps: straight flames spread
+// to both sides, diagonal flames take the two cells they cut between.
+struct Stencil {
+    int count;
+    std::pair<int, int> offsets[3*FLAME_LENGTH];
+};
+
+static constexpr Stencil make_flame_stencil(int dir) {
+    Stencil stencil {};
+    int d_row = directions[dir].first;
+    int d_col = directions[dir].second;
+    if (dir == 0) {
+        return stencil;
+    }
+    std::pair<int, int> sides[3] = {{0, 0}, {d_col, d_row}, {-d_col, -d_row}};
+    if (d_row != 0 && d_col != 0) {
+        sides[1] = {-d_row, 0};
+        sides[2] = {0, -d_col};
+    }
+    for (int k = 1; k <= FLAME_LENGTH; k++) {
+        for (const std::pair<int, int>& side : sides) {
+            stencil.offsets[stencil.count++] = {k*d_row + side.first, k*d_col + side.second};
+        }
+    }
+    return stencil;
+}
+
+static constexpr Stencil FLAME_STENCILS[9] = {
+    make_flame_stencil(0), make_flame_stencil(1), make_flame_stencil(2),
+    make_flame_stencil(3), make_flame_stencil(4), make_flame_stencil(5),
+    make_flame_stencil(6), make_flame_stencil(7), make_flame_stencil(8)
+};
+
+// the 3x3 blast around the aim point, which is just directions[] with its placeholder as the center
+static constexpr Stencil make_grenade_stencil() {
+    Stencil stencil {};
+    for (const std::pair<int, int>& offset : directions) {
+        stencil.offsets[stencil.count++] = offset;
+    }
+    return stencil;
+}
+
+static constexpr Stencil GRENADE_STENCIL = make_grenade_stencil();
+
+// directions[] index for the sign of a row and column step
+static const int DIRECTION_OF[3][3] = {
+    {8, 1, 2},
+    {7, 0, 3},
+    {6, 5, 4}
+};
+
+static int sign(long long value) {
+    return (value > 0) - (value < 0);
+}
+
+static void apply_stencil(const Stencil& stencil, int row, int col, int height, int width, std::vector<int>& cells) {
+    // done in long long, a grenade aimed at INT_MAX must still land off the board
+    for (int i = 0; i < stencil.count; i++) {
+        long long r = (long long)row + stencil.offsets[i].first;
+        long long c = (long long)col + stencil.offsets[i].second;
+        if (r >= 0 && r < height && c >= 0 && c < width) {
+            cells.push_back((int)(r*width + c));
+        }
+    }
+}
+
+static void line_cells(int start_row, int start_col, long long d_row, long long d_col, int height, int width, std::vector<int>& cells) {
+    // one cell per step along the longer axis, the shorter axis rounded to the nearest cell
+    // (halves round away from the shooter). error holds twice the remainder plus steps,
+    // so the rounding is a compare instead of a division. an aim anywhere in int range
+    // keeps every term well inside long long, and the walk ends at the edge of the board
+    long long abs_row = std::llabs(d_row);
+    long long abs_col = std::llabs(d_col);
+    long long steps = std::max(abs_row, abs_col);
+    long long minor = std::min(abs_row, abs_col);
+    if (steps == 0) {
+        return;
+    }
+    int row = start_row;
+    int col = start_col;
+    long long error = steps;
+    while (true) {
+        error += 2*minor;
+        bool minor_step = error >= 2*steps;
+        if (minor_step) {
+            error -= 2*steps;
+        }
+        if (abs_row >= abs_col) {
+            row += sign(d_row);
+            col += minor_step ? sign(d_col) : 0;
+        } else {
+            col += sign(d_col);
+            row += minor_step ? sign(d_row) : 0;
+        }
+        if (row < 0 || row >= height || col < 0 || col >= width) {
+            return;
+        }
+        cells.push_back(row*width + col);
+    }
+}
+
+int aim_direction(long long d_row, long long d_col) {
+    // the first step of the line rounds the shorter axis, so shallow shots go straight
+    long long steps = std::max(std::llabs(d_row), std::llabs(d_col));
+    if (steps == 0) {
+        return 0;
+    }
+    int step_row = 2*std::llabs(d_row) >= steps ? sign(d_row) : 0;
+    int step_col = 2*std::llabs(d_col) >= steps ? sign(d_col) : 0;
+    return DIRECTION_OF[step_row + 1][step_col + 1];
+}
+
+void shot_cells(WeaponType weapon, int start_row, int start_col, int aim_row, int aim_col,
+                int height, int width, std::vector<int>& cells) {
+    // the aim comes straight from the robot and can be anything, so the distance to it is a long long
+    long long d_row = (long long)aim_row - start_row;
+    long long d_col = (long long)aim_col - start_col;
+    switch (weapon) {
+        case flamethrower:
+            // 4 long, 3 wide, in the direction of the aim point
+            apply_stencil(FLAME_STENCILS[aim_direction(d_row, d_col)], start_row, start_col, height, width, cells);
+            break;
+        case railgun:
+            // through everything, all the way to the edge of the board
+            line_cells(start_row, start_col, d_row, d_col, height, width, cells);
+            break;
+        case grenade:
+            // 3x3 anywhere on the board
+            apply_stencil(GRENADE_STENCIL, aim_row, aim_col, height, width, cells);
+            break;
+        case hammer: {
+            // the neighbouring cell the aim point is in the direction of
+            int dir = aim_direction(d_row, d_col);
+            int row = start_row + directions[dir].first;
+            int col = start_col + directions[dir].second;
+            if (dir != 0 && row >= 0 && row < height && col >= 0 && col < width) {
+                cells.push_back(row*width + col);
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "RobotBase.h"
+
+struct WeaponDamage {
+    int low;
+    int high;
+};
+
+// damage rolls from the spec, in WeaponType order
+constexpr WeaponDamage WEAPON_DAMAGE[4] = {
+    {30, 50},   // flamethrower
+    {10, 20},   // railgun
+    {10, 40},   // grenade
+    {50, 60}    // hammer
+};
+
+const int FLAME_LENGTH = 4;
+
+// the entry in directions[] a shot at (d_row, d_col) away heads off in, 0 for the robot's own cell.
+// this is the first cell of the railgun line, so a flame or a hammer goes where a railgun would.
+// long long so the distance to any int aim point fits.
+int aim_direction(long long d_row, long long d_col);
+
+// appends the board index of every cell the shot covers, clipped to the board, each cell once.
+// integer only: the flamethrower and grenade use fixed stencils and the railgun walks a
+// Bresenham line from the shooter through the aim point to the edge of the board.
+// the aim point may be anywhere in int range, on the board or not.
+void shot_cells(WeaponType weapon, int start_row, int start_col, int aim_row, int aim_col,
+                int height, int width, std::vector<int>& cells);
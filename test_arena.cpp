@@ -0,0 +1,575 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include "Arena.h"
+#include "MatchLog.h"
+
+// checks on the arena as a whole, each against an answer worked out without it:
+// batched damage against the spec's hit by hit rule, simultaneous matches decided on
+// several threads, or resolved on tiles, against the same matches played on one, matches
+// played on from a restored snapshot against the same matches played straight through, free
+// cell draws against the cells that really are free, and matches rebuilt from their logs against how they ended.
+// returns 1 if any check failed.
+
+const uint64_t CHECK_SEED = 20240817;
+const std::string CHECK_LOG = "test_arena.log";
+
+static int failures = 0;
+
+void expect(const std::string& check, const std::string& what, long long got, long long expected) {
+    if (got != expected) {
+        failures++;
+        std::cout << check << ": " << what << " is " << got << ", expected " << expected << std::endl;
+    }
+}
+
+// a robot that never does anything, the checks drive the arena directly
+class CheckRobot : public RobotBase {
+public:
+    CheckRobot(int move, int armor, WeaponType weapon) : RobotBase(move, armor, weapon) {}
+    void get_radar_direction(int& radar_direction) override {
+        radar_direction = 0;
+    }
+    void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+        (void) radar_results;
+    }
+    bool get_shot_location(int& shot_row, int& shot_col) override {
+        (void) shot_row;
+        (void) shot_col;
+        return false;
+    }
+    void get_move_direction(int& move_direction, int& move_distance) override {
+        move_direction = 0;
+        move_distance = 0;
+    }
+};
+
+// a robot that plays a real game but remembers nothing from one turn to the next: everything it
+// does is a hash of where it stands, how it is doing and what its radar saw this turn. so a seed
+// replays its matches exactly, and a fresh one made partway through plays on just like the old one
+class PatrolRobot : public RobotBase {
+private:
+    uint64_t m_salt;
+    int m_seen;
+    int m_target_row;
+    int m_target_col;
+    uint64_t mix(uint64_t extra) {
+        int row;
+        int col;
+        get_current_location(row, col);
+        uint64_t z = m_salt + extra * 0x9e3779b97f4a7c15ull + (uint64_t)row * 1000003 + (uint64_t)col * 7919
+                   + (uint64_t)get_health() * 131 + get_armor() + (uint64_t)m_seen * 65537;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+public:
+    PatrolRobot(int move, int armor, WeaponType weapon, uint64_t salt)
+        : RobotBase(move, armor, weapon), m_salt(salt), m_seen(0), m_target_row(-1), m_target_col(-1) {}
+    void get_radar_direction(int& radar_direction) override {
+        // a turn starts here, nothing seen yet
+        m_seen = 0;
+        m_target_row = -1;
+        radar_direction = mix(1) % 9;
+    }
+    void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+        // aims at the nearest robot still standing
+        int row;
+        int col;
+        get_current_location(row, col);
+        m_seen = radar_results.size();
+        m_target_row = -1;
+        int nearest = 0;
+        for (const RadarObj& object : radar_results) {
+            int distance = std::max(std::abs(object.m_row - row), std::abs(object.m_col - col));
+            if (object.m_type == 'R' && (m_target_row < 0 || distance < nearest)) {
+                m_target_row = object.m_row;
+                m_target_col = object.m_col;
+                nearest = distance;
+            }
+        }
+    }
+    bool get_shot_location(int& shot_row, int& shot_col) override {
+        if (m_target_row < 0 || mix(2) % 4 == 0) {
+            return false;
+        }
+        shot_row = m_target_row;
+        shot_col = m_target_col;
+        return true;
+    }
+    void get_move_direction(int& move_direction, int& move_distance) override {
+        uint64_t roll = mix(3);
+        move_direction = 1 + roll % 8;
+        move_distance = 1 + (roll >> 8) % std::max(get_move_speed(), 1);
+    }
+};
+
+// the patrol robots a checked match plays with, as factories so the arena can make fresh ones
+RobotBase* make_railgunner() {
+    return new PatrolRobot(3, 2, railgun, 11);
+}
+RobotBase* make_grenadier() {
+    return new PatrolRobot(2, 3, grenade, 23);
+}
+RobotBase* make_flamer() {
+    return new PatrolRobot(4, 1, flamethrower, 37);
+}
+RobotBase* make_hammerer() {
+    return new PatrolRobot(5, 0, hammer, 53);
+}
+const RobotFactory PATROL_FACTORIES[4] = {make_railgunner, make_grenadier, make_flamer, make_hammerer};
+
+// the board most checks play on, a width that lines no row up with the bit board's 64 cell blocks
+const int PATROL_HEIGHT = 24;
+const int PATROL_WIDTH = 31;
+
+// a crowded board for the patrol robots, every obstacle type and plenty of them (60 mounds,
+// 12 pits and 70 flames to every 24x31)
+Arena* patrol_arena(uint64_t seed, int robots, int height, int width) {
+    Arena* arena = new Arena(height, width, true);
+    int cells = height*width;
+    arena->set_seed(seed);
+    arena->set_obstacles(60*cells/744, 12*cells/744, 70*cells/744);
+    arena->set_max_rounds(300);
+    for (int i = 0; i < robots; i++) {
+        arena->add_robot_from(RobotLibrary {"patrol" + std::to_string(i), nullptr, PATROL_FACTORIES[i % 4]});
+    }
+    return arena;
+}
+
+// everything about how a match ended that the checks compare
+struct Ending {
+    MatchResult result;
+    std::string board;
+    ArenaSnapshot snapshot;
+};
+
+void read_ending(Arena& arena, int height, int width, const MatchResult& result, Ending& ending) {
+    ending.result = result;
+    ending.board.clear();
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            ending.board += arena.cell_at(row, col);
+        }
+    }
+    arena.take_snapshot(ending.snapshot);
+}
+
+void compare_endings(const std::string& check, const Ending& got, const Ending& expected) {
+    expect(check, "winner", got.result.winner, expected.result.winner);
+    expect(check, "rounds", got.result.rounds, expected.result.rounds);
+    expect(check, "robots", got.result.robots.size(), expected.result.robots.size());
+    for (size_t i = 0; i < got.result.robots.size() && i < expected.result.robots.size(); i++) {
+        std::string robot = "robot " + std::to_string(i);
+        expect(check, robot + " damage dealt", got.result.robots[i].damage_dealt, expected.result.robots[i].damage_dealt);
+        expect(check, robot + " damage taken", got.result.robots[i].damage_taken, expected.result.robots[i].damage_taken);
+        expect(check, robot + " alive", got.result.robots[i].alive, expected.result.robots[i].alive);
+        const RobotSnapshot& a = got.snapshot.robots[i];
+        const RobotSnapshot& b = expected.snapshot.robots[i];
+        expect(check, robot + " row", a.row, b.row);
+        expect(check, robot + " col", a.col, b.col);
+        expect(check, robot + " health", a.health, b.health);
+        expect(check, robot + " armor", a.armor, b.armor);
+        expect(check, robot + " grenades", a.grenades, b.grenades);
+    }
+    if (got.board != expected.board) {
+        failures++;
+        std::cout << check << ": the boards the matches ended on differ" << std::endl;
+    }
+}
+
+void check_threads() {
+    // the same seeded simultaneous matches decided on one thread and on several must end the same way,
+    // down to every robot's damage and the board
+    const int threads[] = {2, 4, 7};
+    for (uint64_t seed = CHECK_SEED; seed < CHECK_SEED + 6; seed++) {
+        Ending single;
+        Arena* arena = patrol_arena(seed, 16, PATROL_HEIGHT, PATROL_WIDTH);
+        arena->set_simultaneous(true, 1);
+        read_ending(*arena, PATROL_HEIGHT, PATROL_WIDTH, arena->play_match(), single);
+        delete arena;
+        if (single.result.rounds < 5) {
+            failures++;
+            std::cout << "threads: seed " << seed << " is over after " << single.result.rounds << " rounds, too soon to show anything" << std::endl;
+        }
+        for (int count : threads) {
+            Ending several;
+            arena = patrol_arena(seed, 16, PATROL_HEIGHT, PATROL_WIDTH);
+            arena->set_simultaneous(true, count);
+            read_ending(*arena, PATROL_HEIGHT, PATROL_WIDTH, arena->play_match(), several);
+            delete arena;
+            compare_endings("seed " + std::to_string(seed) + " on " + std::to_string(count) + " threads", several, single);
+        }
+    }
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void check_tiles() {
+    // simultaneous matches whose moves and hits are resolved on tiles must end the same way as on one thread,
+    // and write the same log, event for event. a 64 wide board lets a tile be a single row, so on the
+    // smaller tile sizes most moves and a good share of the hits are on a different tile from the next robot's
+    const int tile_rows[] = {1, 2, 5, 16, 0};
+    const int height = 48;
+    const int width = 64;
+    for (uint64_t seed = CHECK_SEED; seed < CHECK_SEED + 4; seed++) {
+        Ending single;
+        Arena* arena = patrol_arena(seed, 40, height, width);
+        arena->set_simultaneous(true, 1);
+        arena->set_log_path(CHECK_LOG);
+        read_ending(*arena, height, width, arena->play_match(), single);
+        delete arena;
+        std::string single_log = read_file(CHECK_LOG);
+        if (single.result.rounds < 5) {
+            failures++;
+            std::cout << "tiles: seed " << seed << " is over after " << single.result.rounds << " rounds, too soon to show anything" << std::endl;
+        }
+        for (int rows : tile_rows) {
+            std::string check = "seed " + std::to_string(seed) + " on tiles of " + std::to_string(rows) + " rows";
+            Ending tiled;
+            arena = patrol_arena(seed, 40, height, width);
+            arena->set_simultaneous(true, 4);
+            arena->set_tile_rows(rows);
+            arena->set_log_path(CHECK_LOG);
+            read_ending(*arena, height, width, arena->play_match(), tiled);
+            delete arena;
+            compare_endings(check, tiled, single);
+            if (read_file(CHECK_LOG) != single_log) {
+                failures++;
+                std::cout << check << ": the log differs from the one written on one thread" << std::endl;
+            }
+        }
+    }
+    std::remove(CHECK_LOG.c_str());
+}
+
+void check_snapshots() {
+    // a match snapshotted partway, played to the end, then restored and played to the end again must end
+    // the same way both times. in most, grenadiers have thrown grenades and robots have been hurt since
+    // the snapshot, and RobotBase can't give those back, so restoring has to make fresh robots from the factories
+    const int snapshot_rounds[] = {1, 6, 12};
+    int thrown = 0;
+    int rebuilt_matches = 0;
+    for (int simultaneous = 0; simultaneous < 2; simultaneous++) {
+        for (uint64_t seed = CHECK_SEED; seed < CHECK_SEED + 4; seed++) {
+            for (int round : snapshot_rounds) {
+                std::string check = std::string(simultaneous ? "simultaneous" : "turn by turn") + " seed " + std::to_string(seed)
+                                  + " restored to round " + std::to_string(round + 1);
+                Arena* arena = patrol_arena(seed, 12, PATROL_HEIGHT, PATROL_WIDTH);
+                arena->set_simultaneous(simultaneous, 2);
+                arena->start_match();
+                bool playing = true;
+                for (int r = 0; r < round && playing; r++) {
+                    playing = arena->play_round();
+                }
+                if (!playing) {
+                    failures++;
+                    std::cout << check << ": the match was over before the snapshot" << std::endl;
+                    delete arena;
+                    continue;
+                }
+                ArenaSnapshot snapshot;
+                arena->take_snapshot(snapshot);
+                while (arena->play_round()) {
+                }
+                Ending straight;
+                read_ending(*arena, PATROL_HEIGHT, PATROL_WIDTH, arena->finish_match(), straight);
+                // robots that lost something RobotBase can't give back have to be made afresh to restore
+                int rebuilt = 0;
+                for (size_t i = 0; i < snapshot.robots.size(); i++) {
+                    const RobotSnapshot& then = snapshot.robots[i];
+                    const RobotSnapshot& now = straight.snapshot.robots[i];
+                    thrown += then.grenades - now.grenades;
+                    rebuilt += now.health < then.health || now.armor < then.armor || now.grenades < then.grenades || now.move < then.move;
+                }
+                rebuilt_matches += rebuilt > 0;
+
+                if (!arena->restore_snapshot(snapshot)) {
+                    failures++;
+                    std::cout << check << ": the snapshot didn't restore" << std::endl;
+                    delete arena;
+                    continue;
+                }
+                Ending restored;
+                read_ending(*arena, PATROL_HEIGHT, PATROL_WIDTH, MatchResult {}, restored);
+                compare_endings(check + ", as restored", restored, Ending {MatchResult {}, restored.board, snapshot});
+                while (arena->play_round()) {
+                }
+                read_ending(*arena, PATROL_HEIGHT, PATROL_WIDTH, arena->finish_match(), restored);
+                compare_endings(check, restored, straight);
+                delete arena;
+            }
+        }
+    }
+
+    if (thrown == 0 || rebuilt_matches == 0) {
+        failures++;
+        std::cout << "snapshots: no robot had to be made afresh to restore any of them" << std::endl;
+    }
+
+    // a robot handed in ready made has no factory, so it can't be given back the grenades it threw
+    Arena arena(10, 10, true);
+    arena.set_seed(CHECK_SEED);
+    arena.add_robot(make_grenadier(), "grenadier");
+    arena.add_robot(make_railgunner(), "railgunner");
+    arena.start_match();
+    ArenaSnapshot snapshot;
+    arena.take_snapshot(snapshot);
+    snapshot.robots[0].grenades++;
+    std::cout << "(a robot that can't be rewound is reported next, that is expected)" << std::endl;
+    expect("snapshot without a factory", "restored", arena.restore_snapshot(snapshot), false);
+}
+
+void check_free_cells() {
+    // every draw is a free cell on the board that hasn't come up before, and once every cell
+    // has come up the draws say so with -1, however full the board was to begin with
+    const int sizes[][2] = {{10, 10}, {13, 29}, {64, 65}};
+    const int taken_percent[] = {0, 50, 97};
+    int board = 0;
+    for (const int* size : sizes) {
+        for (int percent : taken_percent) {
+            int height = size[0];
+            int width = size[1];
+            std::string check = "free cells on " + std::to_string(height) + "x" + std::to_string(width) + " " + std::to_string(percent) + "% full";
+            Arena arena(height, width, true);
+            arena.set_seed(CHECK_SEED + board++);
+            // cells put down directly, without a draw, which the draws must still step around
+            std::vector<bool> free(height*width, true);
+            Rng rng(CHECK_SEED);
+            int left = height*width;
+            for (int i = 0; i < height*width; i++) {
+                if (rng.below(100) < percent) {
+                    arena.set_cell(i, 'M');
+                    free[i] = false;
+                    left--;
+                }
+            }
+            int drawn = 0;
+            int cell;
+            while ((cell = arena.draw_free_cell()) >= 0) {
+                if (cell >= height*width || !free[cell]) {
+                    failures++;
+                    std::cout << check << ": drew cell " << cell << ", which isn't free" << std::endl;
+                    break;
+                }
+                free[cell] = false;
+                arena.set_cell(cell, 'R');
+                drawn++;
+            }
+            expect(check, "cells drawn", drawn, left);
+            expect(check, "a draw after the last", arena.draw_free_cell(), -1);
+        }
+    }
+
+    // a start with more robots than the room left places as many as fit, leaving no cell empty
+    Arena arena(10, 10, true);
+    arena.set_seed(CHECK_SEED);
+    arena.set_obstacles(90, 2, 3);
+    for (int i = 0; i < 7; i++) {
+        arena.add_robot(new CheckRobot(2, 0, railgun), "crowd" + std::to_string(i));
+    }
+    std::cout << "(two robots with no room are reported next, that is expected)" << std::endl;
+    arena.start_match();
+    int empty = 0;
+    int robots = 0;
+    for (int row = 0; row < 10; row++) {
+        for (int col = 0; col < 10; col++) {
+            empty += arena.cell_at(row, col) == '.';
+            robots += arena.cell_at(row, col) == 'R';
+        }
+    }
+    expect("a full start", "empty cells", empty, 0);
+    expect("a full start", "robots placed", robots, 5);
+    expect("a full start", "a draw after it", arena.draw_free_cell(), -1);
+}
+
+void check_logs() {
+    // a seeded match's log, played back the way RobotReplay plays it, has to end on the board the
+    // match ended on, with every robot where the match left it and the damage the result gives
+    for (int simultaneous = 0; simultaneous < 2; simultaneous++) {
+        for (uint64_t seed = CHECK_SEED; seed < CHECK_SEED + 4; seed++) {
+            std::string check = std::string(simultaneous ? "simultaneous" : "turn by turn") + " seed " + std::to_string(seed) + " replayed from its log";
+            Arena* arena = patrol_arena(seed, 12, PATROL_HEIGHT, PATROL_WIDTH);
+            arena->set_simultaneous(simultaneous, 2);
+            arena->set_log_path(CHECK_LOG);
+            Ending ending;
+            read_ending(*arena, PATROL_HEIGHT, PATROL_WIDTH, arena->play_match(), ending);
+            delete arena;
+
+            MatchLogView log;
+            if (!log.open(CHECK_LOG)) {
+                failures++;
+                std::cout << check << ": no log written" << std::endl;
+                continue;
+            }
+            const MatchLogHeader& header = log.header();
+            expect(check, "seed", header.seed == ending.result.seed, true);
+            expect(check, "robots", header.robot_count, ending.result.robots.size());
+            ReplayBoard board;
+            reset_replay(board, header);
+            for (size_t e = 0; e < log.event_count(); e++) {
+                apply_event(board, log.events()[e]);
+            }
+            const MatchEvent& end = log.events()[log.event_count() - 1];
+            expect(check, "last event", end.type, EVENT_END);
+            expect(check, "winner", end.values[0], ending.result.winner);
+            expect(check, "rounds", end.values[1], ending.result.rounds);
+            if (std::string(board.cells.begin(), board.cells.end()) != ending.board) {
+                failures++;
+                std::cout << check << ": the replayed board isn't the one the match ended on" << std::endl;
+            }
+            for (size_t i = 0; i < ending.result.robots.size() && (int)i < header.robot_count; i++) {
+                std::string robot = "robot " + std::to_string(i);
+                const RobotSnapshot& state = ending.snapshot.robots[i];
+                expect(check, robot + " damage dealt", board.damage_dealt[i], ending.result.robots[i].damage_dealt);
+                expect(check, robot + " damage taken", board.damage_taken[i], ending.result.robots[i].damage_taken);
+                if (state.row >= 0) {
+                    expect(check, robot + " on its cell", board.cell_robot[state.row*board.width + state.col], i);
+                }
+            }
+            log.close();
+        }
+    }
+    std::remove(CHECK_LOG.c_str());
+}
+
+struct Hit {
+    int robot;
+    int attacker;
+    int damage;
+};
+
+// what a hit got through and left its robot on
+struct Landed {
+    int damage;
+    int health;
+    int armor;
+};
+
+void check_damage() {
+    // several hits queued at once on two armored robots, from different attackers and the arena,
+    // resolved as one batch. the answer comes from taking the hits one at a time in the order
+    // they were queued, the way the spec describes a hit: armor blocks 10% a point and wears
+    // down a point, a hit that kills takes what health is left and nothing lands after it
+    const std::string check = "batched damage";
+    const std::vector<Hit> hits = {
+        {0, 1, 40}, {3, 2, 30}, {0, 2, 35}, {0, -1, 20}, {0, 1, 50}, {3, 1, 25}, {0, 2, 60}, {0, 1, 30}, {3, 3, 45}
+    };
+    Arena arena(10, 10, true);
+    arena.set_seed(CHECK_SEED);
+    arena.set_obstacles(0, 0, 0);
+    arena.set_log_path(CHECK_LOG);
+    std::vector<RobotBase*> robots = {
+        new CheckRobot(3, 4, hammer), new CheckRobot(2, 0, railgun), new CheckRobot(2, 0, flamethrower), new CheckRobot(5, 2, grenade)
+    };
+    for (size_t i = 0; i < robots.size(); i++) {
+        arena.add_robot(robots[i], "robot" + std::to_string(i));
+    }
+    arena.start_match();
+
+    std::vector<int> health;
+    std::vector<int> armor;
+    for (RobotBase* robot : robots) {
+        health.push_back(robot->get_health());
+        armor.push_back(robot->get_armor());
+    }
+    std::vector<int> dealt(robots.size(), 0);
+    std::vector<int> taken(robots.size(), 0);
+    // what each robot's hits should leave it on, hit by hit, in the order they were queued
+    std::vector<std::vector<Landed>> landed(robots.size());
+    for (const Hit& hit : hits) {
+        arena.queue_damage(hit.damage, hit.damage, hit.robot, hit.attacker);
+        int& robot_health = health[hit.robot];
+        int& robot_armor = armor[hit.robot];
+        if (robot_health == 0) {
+            continue;
+        }
+        int through = (hit.damage - hit.damage*(robot_armor*0.1)) / 1;
+        if (through >= robot_health) {
+            through = robot_health;
+            robot_health = 0;
+        } else {
+            robot_health -= through;
+            robot_armor = std::max(robot_armor - 1, 0);
+        }
+        taken[hit.robot] += through;
+        if (hit.attacker >= 0 && hit.attacker != hit.robot) {
+            dealt[hit.attacker] += through;
+        }
+        landed[hit.robot].push_back(Landed {through, robot_health, robot_armor});
+    }
+    arena.resolve_damage();
+
+    ArenaSnapshot snapshot;
+    arena.take_snapshot(snapshot);
+    for (size_t i = 0; i < robots.size(); i++) {
+        std::string robot = "robot " + std::to_string(i);
+        expect(check, robot + " health", snapshot.robots[i].health, health[i]);
+        expect(check, robot + " armor", snapshot.robots[i].armor, armor[i]);
+        expect(check, robot + "'s own health", robots[i]->get_health(), health[i]);
+        expect(check, robot + "'s own armor", robots[i]->get_armor(), armor[i]);
+        expect(check, robot + " on the board", arena.cell_at(snapshot.robots[i].row, snapshot.robots[i].col), health[i] ? 'R' : 'X');
+    }
+    MatchResult result = arena.finish_match();
+    for (size_t i = 0; i < robots.size(); i++) {
+        std::string robot = "robot " + std::to_string(i);
+        expect(check, robot + " damage dealt", result.robots[i].damage_dealt, dealt[i]);
+        expect(check, robot + " damage taken", result.robots[i].damage_taken, taken[i]);
+        expect(check, robot + " alive", result.robots[i].alive, health[i] > 0);
+    }
+
+    // the log has a damage event per hit that landed, a robot at a time, each robot's in the order they were queued
+    MatchLogView log;
+    if (!log.open(CHECK_LOG)) {
+        failures++;
+        std::cout << check << ": no log written" << std::endl;
+        return;
+    }
+    std::vector<Landed> logged;
+    std::vector<int> logged_robots;
+    for (size_t e = 0; e < log.event_count(); e++) {
+        const MatchEvent& event = log.events()[e];
+        if (event.type == EVENT_DAMAGE) {
+            logged.push_back(Landed {event.values[1], event.values[2], event.values[3]});
+            logged_robots.push_back(event.robot);
+        }
+    }
+    size_t next = 0;
+    for (size_t i = 0; i < robots.size(); i++) {
+        for (size_t h = 0; h < landed[i].size(); h++, next++) {
+            std::string step = "robot " + std::to_string(i) + " hit " + std::to_string(h + 1);
+            if (next >= logged.size()) {
+                failures++;
+                std::cout << check << ": " << step << " is missing from the log" << std::endl;
+                continue;
+            }
+            expect(check, step + " robot", logged_robots[next], i);
+            expect(check, step + " damage", logged[next].damage, landed[i][h].damage);
+            expect(check, step + " health after", logged[next].health, landed[i][h].health);
+            expect(check, step + " armor after", logged[next].armor, landed[i][h].armor);
+        }
+    }
+    expect(check, "damage events logged", logged.size(), next);
+    log.close();
+    std::remove(CHECK_LOG.c_str());
+}
+
+int main() {
+    check_damage();
+    check_threads();
+    check_snapshots();
+    check_free_cells();
+    check_logs();
+    check_tiles();
+    std::cout << (failures ? std::to_string(failures) + " arena checks failed" : "every arena check passed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "Arena.h"
+#include "ArenaConfig.h"
+#include "Rng.h"
+
+// checks Arena::scan_radar against the slowest possible radar: walk every cell of the ray,
+// nearest first, and note whatever isn't empty. random boards of random sizes and densities
+// are scanned from random cells in every direction, then shot at and moved about so the
+// bit board and board index are checked while they change as well.
+// test_radar [BOARDS] checks that many boards, returns 1 if any scan disagreed.
+
+const uint64_t CHECK_SEED = 20240817;
+const int CHECK_BOARDS = 200;
+const int CHECK_ROUNDS = 10;   // rounds of scans and changes per board
+const int CHECK_SCANS = 20;    // cells scanned from per round, in every direction
+
+// a robot that never does anything, the check drives the arena directly
+class CheckRobot : public RobotBase {
+public:
+    CheckRobot(WeaponType weapon) : RobotBase(3, 2, weapon) {}
+    void get_radar_direction(int& radar_direction) override {
+        radar_direction = 0;
+    }
+    void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+        (void) radar_results;
+    }
+    bool get_shot_location(int& shot_row, int& shot_col) override {
+        (void) shot_row;
+        (void) shot_col;
+        return false;
+    }
+    void get_move_direction(int& move_direction, int& move_distance) override {
+        move_direction = 0;
+        move_distance = 0;
+    }
+};
+
+void walk_radar(Arena& arena, int height, int width, int dir, int row, int col, std::vector<RadarObj>& results) {
+    // the ray as the spec describes it: the ring of 8 for direction 0, otherwise three lines side by side
+    // (a diagonal takes the two cells it cuts between), walked a step at a time, lines in this order on each step
+    results.clear();
+    int d_row = directions[dir].first;
+    int d_col = directions[dir].second;
+    std::vector<std::pair<int, int>> cells;
+    if (dir == 0) {
+        for (int i = 1; i <= 8; i++) {
+            cells.push_back({row + directions[i].first, col + directions[i].second});
+        }
+    } else {
+        std::pair<int, int> offsets[3] = {{0, 0}, {d_col, d_row}, {-d_col, -d_row}};
+        if (d_row != 0 && d_col != 0) {
+            offsets[1] = {-d_row, 0};
+            offsets[2] = {0, -d_col};
+        }
+        for (int k = 1; k <= height + width; k++) {
+            for (const std::pair<int, int>& offset : offsets) {
+                cells.push_back({row + offset.first + k*d_row, col + offset.second + k*d_col});
+            }
+        }
+    }
+    for (const std::pair<int, int>& cell : cells) {
+        if (cell.first >= 0 && cell.first < height && cell.second >= 0 && cell.second < width) {
+            char type = arena.cell_at(cell.first, cell.second);
+            if (type != '.') {
+                results.push_back(RadarObj {type, cell.first, cell.second});
+            }
+        }
+    }
+}
+
+bool same_results(const std::vector<RadarObj>& a, const std::vector<RadarObj>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].m_type != b[i].m_type || a[i].m_row != b[i].m_row || a[i].m_col != b[i].m_col) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_results(const std::string& label, const std::vector<RadarObj>& results) {
+    std::cerr << "  " << label << ":";
+    for (const RadarObj& object : results) {
+        std::cerr << " " << object.m_type << "(" << object.m_row << "," << object.m_col << ")";
+    }
+    std::cerr << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int boards = argc > 1 ? std::atoi(argv[1]) : CHECK_BOARDS;
+    Rng rng(CHECK_SEED);
+    long long scans = 0;
+    int mismatches = 0;
+    std::vector<RadarObj> expected;
+    for (int b = 0; b < boards; b++) {
+        // a board anywhere from 10x10 to 73x73, not always square, with up to half of it under obstacles
+        ArenaConfig config = default_config();
+        config.watch_live = false;
+        config.height = MIN_ARENA_SIZE + rng.below(64);
+        config.width = MIN_ARENA_SIZE + rng.below(64);
+        int cells = config.height * config.width;
+        int density = rng.below(50);
+        config.mounds = cells * density / 300;
+        config.pits = cells * density / 300;
+        config.flames = cells * density / 100 - config.mounds - config.pits;
+        config.has_seed = true;
+        config.seed = rng.next();
+        Arena arena(config);
+        // the arena owns the robots, these are kept to read their state back
+        int robots = std::max(2, cells / 20);
+        std::vector<RobotBase*> robot_list;
+        for (int i = 0; i < robots; i++) {
+            robot_list.push_back(new CheckRobot(i % 2 ? grenade : railgun));
+            arena.add_robot(robot_list.back(), "check");
+        }
+        arena.start_match();
+
+        for (int round = 0; round < CHECK_ROUNDS; round++) {
+            for (int s = 0; s < CHECK_SCANS; s++) {
+                int row = rng.below(config.height);
+                int col = rng.below(config.width);
+                for (int dir = 0; dir <= 8; dir++) {
+                    const std::vector<RadarObj>& found = arena.scan_radar(dir, row, col);
+                    walk_radar(arena, config.height, config.width, dir, row, col, expected);
+                    scans++;
+                    if (!same_results(found, expected)) {
+                        mismatches++;
+                        std::cerr << "board " << b << " (" << config.height << "x" << config.width << ", seed " << config.seed
+                                  << ") round " << round << ": scan " << dir << " from " << row << "," << col << " disagrees" << std::endl;
+                        print_results("scan_radar", found);
+                        print_results("walk", expected);
+                    }
+                }
+            }
+            // shake the board up: every robot still standing either shoots somewhere or moves
+            for (int i = 0; i < robots; i++) {
+                int row;
+                int col;
+                robot_list[i]->get_current_location(row, col);
+                if (robot_list[i]->get_health() <= 0) {
+                    continue;
+                }
+                if (rng.below(2)) {
+                    arena.handle_shot(i, robot_list[i]->get_weapon(), rng.below(config.height), rng.below(config.width), row, col);
+                } else {
+                    MoveOrder order {i, 1 + rng.below(8), 1 + rng.below(3), row, col, false};
+                    arena.move_robot(order);
+                }
+            }
+        }
+    }
+    std::cout << scans << " radar scans on " << boards << " boards, " << mismatches << " disagreed with the cell by cell walk" << std::endl;
+    return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <climits>
+
+#include "Weapons.h"
+
+// checks shot_cells against cell lists written out by hand from the spec: the railgun
+// example it gives, a flame in each of the 8 directions, the grenade's 3x3 clipped at the
+// edges and corners, the hammer, and aim points as far off the board as an int goes.
+// returns 1 if any shot covered different cells.
+
+typedef std::vector<std::pair<int, int>> Cells;
+
+static int failures = 0;
+static int checks = 0;
+
+std::string cells_text(const Cells& cells) {
+    std::string text;
+    for (const std::pair<int, int>& cell : cells) {
+        text += " (" + std::to_string(cell.first) + "," + std::to_string(cell.second) + ")";
+    }
+    return text.empty() ? " none" : text;
+}
+
+void expect(const std::string& name, WeaponType weapon, int row, int col, int aim_row, int aim_col,
+            int height, int width, Cells expected, bool in_order) {
+    // the railgun's path is checked in order, the stencils only as a set of cells
+    std::vector<int> indices;
+    shot_cells(weapon, row, col, aim_row, aim_col, height, width, indices);
+    Cells got;
+    for (int index : indices) {
+        got.push_back({index / width, index % width});
+    }
+    if (!in_order) {
+        std::sort(got.begin(), got.end());
+        std::sort(expected.begin(), expected.end());
+    }
+    checks++;
+    if (got != expected) {
+        failures++;
+        std::cout << name << ":" << std::endl << "  expected" << cells_text(expected) << std::endl << "  got     " << cells_text(got) << std::endl;
+    }
+}
+
+void check_on_board(const std::string& name, WeaponType weapon, int row, int col, int aim_row, int aim_col, int height, int width) {
+    // for aims where only staying on the board, each cell once, is known
+    std::vector<int> indices;
+    shot_cells(weapon, row, col, aim_row, aim_col, height, width, indices);
+    std::vector<int> sorted = indices;
+    std::sort(sorted.begin(), sorted.end());
+    checks++;
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()
+            || (!sorted.empty() && (sorted.front() < 0 || sorted.back() >= height*width))) {
+        failures++;
+        std::cout << name << ": cells off the board or covered twice" << std::endl;
+    }
+}
+
+int main() {
+    // the spec's own example, on a 10x10 board
+    expect("railgun (2,2) at (4,5)", railgun, 2, 2, 4, 5, 10, 10,
+           {{3, 3}, {3, 4}, {4, 5}, {5, 6}, {5, 7}, {6, 8}, {7, 9}}, true);
+    expect("railgun (2,2) at (0,2)", railgun, 2, 2, 0, 2, 10, 10, {{1, 2}, {0, 2}}, true);
+    expect("railgun (2,2) at (9,9)", railgun, 2, 2, 9, 9, 10, 10,
+           {{3, 3}, {4, 4}, {5, 5}, {6, 6}, {7, 7}, {8, 8}, {9, 9}}, true);
+    expect("railgun (2,2) at itself", railgun, 2, 2, 2, 2, 10, 10, {}, true);
+
+    // a flame from (5,5) in each direction: 4 cells out, 3 wide, a diagonal between its two neighbours
+    expect("flame up", flamethrower, 5, 5, 0, 5, 10, 10,
+           {{4, 4}, {4, 5}, {4, 6}, {3, 4}, {3, 5}, {3, 6}, {2, 4}, {2, 5}, {2, 6}, {1, 4}, {1, 5}, {1, 6}}, false);
+    expect("flame up-right", flamethrower, 5, 5, 1, 9, 10, 10,
+           {{4, 6}, {5, 6}, {4, 5}, {3, 7}, {4, 7}, {3, 6}, {2, 8}, {3, 8}, {2, 7}, {1, 9}, {2, 9}, {1, 8}}, false);
+    expect("flame right", flamethrower, 5, 5, 5, 9, 10, 10,
+           {{4, 6}, {5, 6}, {6, 6}, {4, 7}, {5, 7}, {6, 7}, {4, 8}, {5, 8}, {6, 8}, {4, 9}, {5, 9}, {6, 9}}, false);
+    expect("flame down-right", flamethrower, 5, 5, 9, 9, 10, 10,
+           {{6, 6}, {5, 6}, {6, 5}, {7, 7}, {6, 7}, {7, 6}, {8, 8}, {7, 8}, {8, 7}, {9, 9}, {8, 9}, {9, 8}}, false);
+    expect("flame down", flamethrower, 5, 5, 9, 5, 10, 10,
+           {{6, 4}, {6, 5}, {6, 6}, {7, 4}, {7, 5}, {7, 6}, {8, 4}, {8, 5}, {8, 6}, {9, 4}, {9, 5}, {9, 6}}, false);
+    expect("flame down-left", flamethrower, 5, 5, 9, 1, 10, 10,
+           {{6, 4}, {5, 4}, {6, 5}, {7, 3}, {6, 3}, {7, 4}, {8, 2}, {7, 2}, {8, 3}, {9, 1}, {8, 1}, {9, 2}}, false);
+    expect("flame left", flamethrower, 5, 5, 5, 0, 10, 10,
+           {{4, 4}, {5, 4}, {6, 4}, {4, 3}, {5, 3}, {6, 3}, {4, 2}, {5, 2}, {6, 2}, {4, 1}, {5, 1}, {6, 1}}, false);
+    expect("flame up-left", flamethrower, 5, 5, 1, 1, 10, 10,
+           {{4, 4}, {5, 4}, {4, 5}, {3, 3}, {4, 3}, {3, 4}, {2, 2}, {3, 2}, {2, 3}, {1, 1}, {2, 1}, {1, 2}}, false);
+    // a shallow aim still goes straight, and the flame stops at 4 however far the aim is
+    expect("flame right, aimed a row low", flamethrower, 5, 5, 6, 9, 10, 10,
+           {{4, 6}, {5, 6}, {6, 6}, {4, 7}, {5, 7}, {6, 7}, {4, 8}, {5, 8}, {6, 8}, {4, 9}, {5, 9}, {6, 9}}, false);
+    expect("flame up from (1,1)", flamethrower, 1, 1, 0, 1, 10, 10, {{0, 0}, {0, 1}, {0, 2}}, false);
+    expect("flame up-left from (0,0)", flamethrower, 0, 0, -5, -5, 10, 10, {}, false);
+    expect("flame at itself", flamethrower, 5, 5, 5, 5, 10, 10, {}, false);
+
+    // the grenade's 3x3, whole in the middle and clipped at an edge, a corner and just off the board
+    expect("grenade at (5,5)", grenade, 0, 0, 5, 5, 10, 10,
+           {{4, 4}, {4, 5}, {4, 6}, {5, 4}, {5, 5}, {5, 6}, {6, 4}, {6, 5}, {6, 6}}, false);
+    expect("grenade at (0,5)", grenade, 9, 9, 0, 5, 10, 10, {{0, 4}, {0, 5}, {0, 6}, {1, 4}, {1, 5}, {1, 6}}, false);
+    expect("grenade at (9,9)", grenade, 0, 0, 9, 9, 10, 10, {{8, 8}, {8, 9}, {9, 8}, {9, 9}}, false);
+    expect("grenade at (0,0)", grenade, 9, 9, 0, 0, 10, 10, {{0, 0}, {0, 1}, {1, 0}, {1, 1}}, false);
+    expect("grenade at (-1,-1)", grenade, 9, 9, -1, -1, 10, 10, {{0, 0}}, false);
+    expect("grenade at (5,10)", grenade, 0, 0, 5, 10, 10, 10, {{4, 9}, {5, 9}, {6, 9}}, false);
+    expect("grenade at (-2,5)", grenade, 9, 9, -2, 5, 10, 10, {}, false);
+
+    // the hammer hits the one neighbour toward the aim point
+    expect("hammer down-right", hammer, 5, 5, 9, 9, 10, 10, {{6, 6}}, false);
+    expect("hammer left", hammer, 5, 5, 5, 0, 10, 10, {{5, 4}}, false);
+    expect("hammer up from (0,3)", hammer, 0, 3, -4, 3, 10, 10, {}, false);
+    expect("hammer at itself", hammer, 5, 5, 5, 5, 10, 10, {}, false);
+
+    // aim points as far off as an int goes, from a corner and the middle
+    expect("railgun (2,2) at (INT_MAX,INT_MAX)", railgun, 2, 2, INT_MAX, INT_MAX, 10, 10,
+           {{3, 3}, {4, 4}, {5, 5}, {6, 6}, {7, 7}, {8, 8}, {9, 9}}, true);
+    expect("railgun (2,2) at (INT_MIN,2)", railgun, 2, 2, INT_MIN, 2, 10, 10, {{1, 2}, {0, 2}}, true);
+    expect("flame (5,5) at (5,INT_MIN)", flamethrower, 5, 5, 5, INT_MIN, 10, 10,
+           {{4, 4}, {5, 4}, {6, 4}, {4, 3}, {5, 3}, {6, 3}, {4, 2}, {5, 2}, {6, 2}, {4, 1}, {5, 1}, {6, 1}}, false);
+    expect("grenade at (INT_MAX,INT_MAX)", grenade, 5, 5, INT_MAX, INT_MAX, 10, 10, {}, false);
+    expect("grenade at (INT_MIN,INT_MIN)", grenade, 5, 5, INT_MIN, INT_MIN, 10, 10, {}, false);
+    expect("hammer (5,5) at (INT_MIN,INT_MAX)", hammer, 5, 5, INT_MIN, INT_MAX, 10, 10, {{4, 6}}, false);
+    const int extremes[] = {INT_MIN, INT_MIN + 1, -1, 0, 1, INT_MAX - 1, INT_MAX};
+    const WeaponType weapons[] = {flamethrower, railgun, grenade, hammer};
+    for (WeaponType weapon : weapons) {
+        for (int aim_row : extremes) {
+            for (int aim_col : extremes) {
+                check_on_board("weapon " + std::to_string(weapon) + " from (0,0) at (" + std::to_string(aim_row) + "," + std::to_string(aim_col) + ")",
+                               weapon, 0, 0, aim_row, aim_col, 13, 29);
+                check_on_board("weapon " + std::to_string(weapon) + " from (12,28) at (" + std::to_string(aim_row) + "," + std::to_string(aim_col) + ")",
+                               weapon, 12, 28, aim_row, aim_col, 13, 29);
+            }
+        }
+    }
+
+    std::cout << checks << " shots checked, " << failures << " covered the wrong cells" << std::endl;
+    return failures == 0 ? 0 : 1;
+}